@@ -647,6 +647,11 @@ u32 *display_init_framebuffer_pitch()
 	// Sanitize framebuffer area.
 	memset((u32 *)IPL_FB_ADDRESS, 0, 0x3C0000);
 
+	return display_activate_framebuffer_pitch();
+}
+
+u32 *display_activate_framebuffer_pitch()
+{
 	// This configures the framebuffer @ IPL_FB_ADDRESS with a resolution of 1280x720 (line stride 720).
 	exec_cfg((u32 *)DISPLAY_A_BASE, cfg_display_framebuffer_pitch, 32);
 	usleep(35000);
@@ -78,7 +78,7 @@ uintptr_t ianos_loader(char *path, elfType_t type, void *moduleConfig)
 		goto elfLoadFinalOut;
 
 	// Read library.
-	fileBuf = sd_file_read(path, NULL);
+	fileBuf = sd_file_read_lz4c(path, NULL);
 
 	if (!fileBuf)
 		goto elfLoadFinalOut;
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "lz4.h"
+#include "lz4c.h"
+#include <mem/heap.h>
+
+static bool _lz4c_blk_buffered(const u8 *buf, u32 avail)
+{
+	u32 csize;
+
+	if (avail < sizeof(u32))
+		return false;
+
+	// Size prefix is not aligned.
+	memcpy(&csize, buf, sizeof(u32));
+
+	return csize <= avail - sizeof(u32);
+}
+
+void *lz4c_file_read(FIL *fp, const lz4c_hdr_t *hdr)
+{
+	LZ4_streamDecode_t lz4_sd;
+	u32 left = f_size(fp) - f_tell(fp);
+	u32 avail = 0;
+	u32 pos = 0;
+	UINT br;
+
+	// Bound the header before trusting it for allocations.
+	if (!hdr->size || hdr->size > LZ4C_SIZE_MAX || !hdr->blk_size || hdr->blk_size > LZ4C_BLK_MAX ||
+		hdr->blk_cnt != (hdr->size + hdr->blk_size - 1) / hdr->blk_size)
+		return NULL;
+
+	u8 *in = (u8 *)malloc(LZ4C_CHUNK_SZ);
+	u8 *out = (u8 *)malloc(ALIGN(hdr->size, 0x10));
+	u8 *op = out;
+	u8 *oend = out + hdr->size;
+
+	LZ4_setStreamDecode(&lz4_sd, NULL, 0);
+
+	for (u32 blk = 0; blk < hdr->blk_cnt; blk++)
+	{
+		// Refill when the next block is not fully buffered. A block always fits in a chunk.
+		if (!_lz4c_blk_buffered(in + pos, avail - pos))
+		{
+			avail -= pos;
+			memmove(in, in + pos, avail);
+			pos = 0;
+
+			u32 rsize = MIN(left, LZ4C_CHUNK_SZ - avail);
+			if (f_read(fp, in + avail, rsize, &br) || br != rsize)
+				goto error;
+			avail += rsize;
+			left -= rsize;
+
+			if (!_lz4c_blk_buffered(in, avail))
+				goto error;
+		}
+
+		u32 csize;
+		memcpy(&csize, in + pos, sizeof(u32));
+		pos += sizeof(u32);
+
+		// Output is contiguous, so previous blocks serve as the dictionary.
+		int dsize = LZ4_decompress_safe_continue(&lz4_sd, (const char *)in + pos, (char *)op,
+			csize, MIN(oend - op, hdr->blk_size));
+		if (dsize <= 0)
+			goto error;
+
+		op += dsize;
+		pos += csize;
+	}
+
+	if (op != oend)
+		goto error;
+
+	free(in);
+
+	return out;
+
+error:
+	free(in);
+	free(out);
+
+	return NULL;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LZ4C_H_
+#define _LZ4C_H_
+
+#ifndef LZ4C_HOST
+#include <libs/fatfs/ff.h>
+#endif
+#include <utils/types.h>
+
+#define LZ4C_MAGIC    0x43345A4C // "LZ4C".
+#define LZ4C_BLK_MAX  0x10000    // Max decompressed block size. Blocks are linked.
+#define LZ4C_SIZE_MAX 0x1000000  // Max decompressed size.
+#define LZ4C_CHUNK_SZ 0x40000    // SD read size while decompressing.
+
+/*
+ * Container layout:
+ *  lz4c_hdr_t, then blocks of u32 compressed size followed by LZ4 data.
+ *  Each block may reference up to 64KB of the previously decompressed output.
+ */
+typedef struct _lz4c_hdr_t
+{
+	u32 magic;
+	u32 size;     // Decompressed size.
+	u32 blk_size; // Decompressed size of every block except the last.
+	u32 blk_cnt;
+} lz4c_hdr_t;
+
+#ifndef LZ4C_HOST
+// Decompresses a container from the current file position. Returns a buffer of hdr->size bytes.
+void *lz4c_file_read(FIL *fp, const lz4c_hdr_t *hdr);
+#endif
+
+#endif
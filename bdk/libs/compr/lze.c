@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lze.h"
+
+typedef struct _lze_rd_t
+{
+	const u8 *src;
+	u32 bits;
+	u32 cnt;
+} lze_rd_t;
+
+static u32 _lze_getbit(lze_rd_t *rd)
+{
+	if (!rd->cnt)
+	{
+		rd->bits = *rd->src++;
+		rd->cnt = 8;
+	}
+	rd->cnt--;
+
+	return (rd->bits >> rd->cnt) & 1;
+}
+
+static u32 _lze_gamma(lze_rd_t *rd)
+{
+	u32 val = 1;
+
+	while (_lze_getbit(rd))
+		val = (val << 1) | _lze_getbit(rd);
+
+	return val;
+}
+
+u32 lze_uncompress(const u8 *in, u8 *out, u32 insize)
+{
+	lze_rd_t rd;
+	const u8 *end = in + insize;
+	u8 *dst = out;
+
+	rd.src = in;
+	rd.cnt = 0;
+
+	while (rd.src < end)
+	{
+		// Literal.
+		if (!_lze_getbit(&rd))
+		{
+			*dst++ = *rd.src++;
+			continue;
+		}
+
+		// Match.
+		u32 offset = (_lze_gamma(&rd) - 1) << 8;
+		offset |= *rd.src++;
+		offset++;
+		u32 len = _lze_gamma(&rd) + 1;
+
+		const u8 *ref = dst - offset;
+		while (len--)
+			*dst++ = *ref++;
+	}
+
+	return dst - out;
+}
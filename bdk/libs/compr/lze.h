@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LZE_H_
+#define _LZE_H_
+
+#include <utils/types.h>
+
+/*
+ * LZE stream: Control bits are packed MSB first into bytes that are placed in
+ * the stream at the point the decoder needs them. Other bytes are data.
+ *  0               Literal: 1 data byte.
+ *  1 G(h) B G(l)   Match: offset = ((h - 1) << 8 | B) + 1, length = l + 1.
+ * G(n) is an interleaved Elias gamma code: (1, bit)* for each bit of n below
+ * its MSB, from high to low, then 0. Matches may overlap their output.
+ */
+
+// Returns the decompressed size. The stream ends with its last data byte.
+u32 lze_uncompress(const u8 *in, u8 *out, u32 insize);
+
+#endif
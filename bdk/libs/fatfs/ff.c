@@ -1065,6 +1065,235 @@ static void clear_lock (	/* Clear lock entries of the volume */
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Window cache - Sectors kept behind the disk access window             */
+/*-----------------------------------------------------------------------*/
+#if FF_WIN_CACHE_SECTORS
+#if FF_FS_TINY
+#error FF_WIN_CACHE_SECTORS requires FF_FS_TINY == 0
+#endif
+#if FF_WIN_CACHE_WAYS < 1 || FF_WIN_CACHE_SECTORS % FF_WIN_CACHE_WAYS
+#error Wrong FF_WIN_CACHE_WAYS setting
+#endif
+#if FF_WIN_CACHE_RA < 1
+#error Wrong FF_WIN_CACHE_RA setting
+#endif
+
+#define WC_SETS		(FF_WIN_CACHE_SECTORS / FF_WIN_CACHE_WAYS)
+#define WC_DATA(fs, i)	((fs)->wc_buf + (i) * SS(fs))
+#define WC_RABUF(fs)	((fs)->wc_buf + FF_WIN_CACHE_SECTORS * SS(fs))
+#define WC_TAGS(fs)		((WCTAG*)((fs)->wc_buf + (FF_WIN_CACHE_SECTORS + FF_WIN_CACHE_RA) * SS(fs)))
+#define WC_SIZE			((FF_WIN_CACHE_SECTORS + FF_WIN_CACHE_RA) * FF_MAX_SS + FF_WIN_CACHE_SECTORS * sizeof (WCTAG))
+
+typedef struct {
+	DWORD	sect;		/* Cached sector (0xFFFFFFFF:free) */
+	DWORD	used;		/* LRU stamp (0:free) */
+	BYTE	dirty;		/* Sector differs from the disk */
+} WCTAG;
+
+
+static void wc_reset (
+	FATFS* fs			/* Filesystem object */
+)
+{
+	WCTAG *tag = WC_TAGS(fs);
+	UINT i;
+
+
+	for (i = 0; i < FF_WIN_CACHE_SECTORS; i++) {
+		tag[i].sect = 0xFFFFFFFF; tag[i].used = 0; tag[i].dirty = 0;
+	}
+	fs->wc_tick = 0;
+	fs->wc_hit = fs->wc_miss = fs->wc_wback = 0;
+}
+
+
+static WCTAG* wc_find (	/* Returns the tag of the cached sector or null */
+	FATFS* fs,			/* Filesystem object */
+	DWORD sect			/* Sector to look up */
+)
+{
+	WCTAG *tag = WC_TAGS(fs) + (sect % WC_SETS) * FF_WIN_CACHE_WAYS;
+	UINT i;
+
+
+	for (i = 0; i < FF_WIN_CACHE_WAYS; i++) {
+		if (tag[i].sect == sect) return &tag[i];
+	}
+	return 0;
+}
+
+
+#if !FF_FS_READONLY
+static FRESULT wc_write (	/* Returns FR_OK or FR_DISK_ERR */
+	FATFS* fs,			/* Filesystem object */
+	const BYTE* buf,	/* Sector data */
+	DWORD sect			/* Sector to write */
+)
+{
+	if (disk_write(fs->pdrv, buf, sect, 1) != RES_OK) return FR_DISK_ERR;
+	if (sect - fs->fatbase < fs->fsize) {	/* Is it in the 1st FAT? */
+		if (fs->n_fats == 2) disk_write(fs->pdrv, buf, sect + fs->fsize, 1);	/* Reflect it to 2nd FAT if needed */
+	}
+	fs->wc_wback++;
+	return FR_OK;
+}
+#endif
+
+
+static FRESULT wc_slot (	/* Returns FR_OK or FR_DISK_ERR */
+	FATFS* fs,			/* Filesystem object */
+	DWORD sect,			/* Sector to make room for */
+	WCTAG** slot		/* Pointer to the returned tag */
+)
+{
+	WCTAG *tag, *vic;
+	UINT i;
+
+
+	vic = wc_find(fs, sect);
+	if (!vic) {		/* Not cached, replace the least recently used way of the set */
+		tag = WC_TAGS(fs) + (sect % WC_SETS) * FF_WIN_CACHE_WAYS;
+		for (vic = tag, i = 1; i < FF_WIN_CACHE_WAYS; i++) {
+			if (tag[i].used < vic->used) vic = &tag[i];
+		}
+#if !FF_FS_READONLY
+		if (vic->dirty) {
+			if (wc_write(fs, WC_DATA(fs, vic - WC_TAGS(fs)), vic->sect) != FR_OK) return FR_DISK_ERR;
+			vic->dirty = 0;
+		}
+#endif
+		vic->sect = sect;
+	}
+	vic->used = ++fs->wc_tick;
+	*slot = vic;
+	return FR_OK;
+}
+
+
+static UINT wc_ra_count (	/* Returns the number of sectors to read at once */
+	FATFS* fs,			/* Filesystem object */
+	DWORD sect			/* Sector to be loaded */
+)
+{
+	DWORD n = 1;
+
+
+	if (fs->fs_type == 0) return 1;		/* Volume is being mounted and the layout is not known yet */
+	if (sect - fs->fatbase < fs->fsize) {	/* FAT: read ahead along the 1st FAT */
+		n = fs->fatbase + fs->fsize - sect;
+	}
+#if FF_FS_EXFAT
+	if (fs->fs_type == FS_EXFAT) {	/* Allocation bitmap: read ahead along the bitmap */
+		DWORD szbm = (fs->n_fatent - 2 + (SS(fs) * 8 - 1)) / (SS(fs) * 8);
+
+		if (sect - fs->bitbase < szbm) n = fs->bitbase + szbm - sect;
+	}
+#endif
+	return (n > FF_WIN_CACHE_RA) ? FF_WIN_CACHE_RA : (UINT)n;
+}
+
+
+static FRESULT wc_load (	/* Returns FR_OK or FR_DISK_ERR */
+	FATFS* fs,			/* Filesystem object */
+	DWORD sect			/* Sector to load into the window */
+)
+{
+	WCTAG *tag;
+	UINT n;
+
+
+	tag = wc_find(fs, sect);
+	if (tag) {		/* Cache hit */
+		fs->wc_hit++;
+		tag->used = ++fs->wc_tick;
+		mem_cpy(fs->win, WC_DATA(fs, tag - WC_TAGS(fs)), SS(fs));
+		return FR_OK;
+	}
+	fs->wc_miss++;
+
+	n = wc_ra_count(fs, sect);
+	if (n == 1) {
+		if (disk_read(fs->pdrv, fs->win, sect, 1) != RES_OK) return FR_DISK_ERR;
+		if (wc_slot(fs, sect, &tag) != FR_OK) return FR_DISK_ERR;
+		mem_cpy(WC_DATA(fs, tag - WC_TAGS(fs)), fs->win, SS(fs));
+		tag->dirty = 0;
+		return FR_OK;
+	}
+
+	/* Read the following FAT/bitmap sectors in the same request */
+	if (disk_read(fs->pdrv, WC_RABUF(fs), sect, n) != RES_OK) return FR_DISK_ERR;
+	do {	/* Insert backwards so the requested sector is the most recent one */
+		n--;
+		tag = wc_find(fs, sect + n);
+		if (tag && tag->dirty) continue;	/* Keep the newer cached copy */
+		if (wc_slot(fs, sect + n, &tag) != FR_OK) return FR_DISK_ERR;
+		mem_cpy(WC_DATA(fs, tag - WC_TAGS(fs)), WC_RABUF(fs) + n * SS(fs), SS(fs));
+	} while (n);
+	mem_cpy(fs->win, WC_RABUF(fs), SS(fs));
+	return FR_OK;
+}
+
+
+#if !FF_FS_READONLY
+static FRESULT wc_store (	/* Returns FR_OK or FR_DISK_ERR */
+	FATFS* fs			/* Filesystem object */
+)
+{
+	WCTAG *tag;
+
+
+	if (wc_slot(fs, fs->winsect, &tag) != FR_OK) return FR_DISK_ERR;
+	mem_cpy(WC_DATA(fs, tag - WC_TAGS(fs)), fs->win, SS(fs));
+	tag->dirty = 1;
+	return FR_OK;
+}
+
+
+static FRESULT wc_flush (	/* Returns FR_OK or FR_DISK_ERR */
+	FATFS* fs			/* Filesystem object */
+)
+{
+	WCTAG *tag = WC_TAGS(fs);
+	FRESULT res = FR_OK;
+	UINT i;
+
+
+	for (i = 0; i < FF_WIN_CACHE_SECTORS; i++) {
+		if (tag[i].dirty) {
+			if (wc_write(fs, WC_DATA(fs, i), tag[i].sect) == FR_OK) {
+				tag[i].dirty = 0;
+			} else {
+				res = FR_DISK_ERR;
+			}
+		}
+	}
+	return res;
+}
+
+
+static void wc_inval (
+	FATFS* fs,			/* Filesystem object */
+	DWORD sect,			/* First sector written around the cache */
+	UINT count			/* Number of sectors */
+)
+{
+	WCTAG *tag = WC_TAGS(fs);
+	UINT i;
+
+
+	for (i = 0; i < FF_WIN_CACHE_SECTORS; i++) {
+		if (tag[i].sect - sect < count) {
+			tag[i].sect = 0xFFFFFFFF; tag[i].used = 0; tag[i].dirty = 0;
+		}
+	}
+}
+#endif
+#endif	/* FF_WIN_CACHE_SECTORS */
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Move/Flush disk access window in the filesystem object                */
 /*-----------------------------------------------------------------------*/
@@ -1077,6 +1306,13 @@ static FRESULT sync_window (	/* Returns FR_OK or FR_DISK_ERR */
 
 
 	if (fs->wflag) {	/* Is the disk access window dirty */
+#if FF_WIN_CACHE_SECTORS
+		if (fs->wc_buf) {	/* Keep it in the cache until sync_fs() */
+			res = wc_store(fs);
+			if (res == FR_OK) fs->wflag = 0;
+			return res;
+		}
+#endif
 		if (disk_write(fs->pdrv, fs->win, fs->winsect, 1) == RES_OK) {	/* Write back the window */
 			fs->wflag = 0;	/* Clear window dirty flag */
 			if (fs->winsect - fs->fatbase < fs->fsize) {	/* Is it in the 1st FAT? */
@@ -1104,10 +1340,15 @@ static FRESULT move_window (	/* Returns FR_OK or FR_DISK_ERR */
 		res = sync_window(fs);		/* Write-back changes */
 #endif
 		if (res == FR_OK) {			/* Fill sector window with new data */
+#if FF_WIN_CACHE_SECTORS
+			if (fs->wc_buf) {
+				res = wc_load(fs, sector);
+			} else
+#endif
 			if (disk_read(fs->pdrv, fs->win, sector, 1) != RES_OK) {
-				sector = 0xFFFFFFFF;	/* Invalidate window if read data is not valid */
 				res = FR_DISK_ERR;
 			}
+			if (res != FR_OK) sector = 0xFFFFFFFF;	/* Invalidate window if read data is not valid */
 			fs->winsect = sector;
 		}
 	}
@@ -1130,6 +1371,9 @@ static FRESULT sync_fs (	/* Returns FR_OK or FR_DISK_ERR */
 
 
 	res = sync_window(fs);
+#if FF_WIN_CACHE_SECTORS
+	if (res == FR_OK && fs->wc_buf) res = wc_flush(fs);	/* Write back the cached sectors */
+#endif
 	if (res == FR_OK) {
 		if (fs->fs_type == FS_FAT32 && fs->fsi_flag == 1) {	/* FAT32: Update FSInfo sector if needed */
 			/* Create FSInfo structure */
@@ -1142,6 +1386,9 @@ static FRESULT sync_fs (	/* Returns FR_OK or FR_DISK_ERR */
 			/* Write it into the FSInfo sector */
 			fs->winsect = fs->volbase + 1;
 			disk_write(fs->pdrv, fs->win, fs->winsect, 1);
+#if FF_WIN_CACHE_SECTORS
+			if (fs->wc_buf) wc_inval(fs, fs->winsect, 1);
+#endif
 			fs->fsi_flag = 0;
 		}
 		/* Make sure that no pending write process in the lower layer */
@@ -1235,8 +1482,8 @@ static DWORD get_fat (		/* 0xFFFFFFFF:Disk error, 1:Internal error, 2..0x7FFFFFF
 					break;
 				}
 			}
-			/* go to default */
 #endif
+			/* Fall through - go to default */
 		default:
 			val = 1;	/* Internal error */
 		}
@@ -1683,6 +1930,9 @@ static FRESULT dir_clear (	/* Returns FR_OK or FR_DISK_ERR */
 
 	if (sync_window(fs) != FR_OK) return FR_DISK_ERR;	/* Flush disk access window */
 	sect = clst2sect(fs, clst);		/* Top of the cluster */
+#if FF_WIN_CACHE_SECTORS
+	if (fs->wc_buf) wc_inval(fs, sect, fs->csize);	/* Drop stale copies of the reused cluster */
+#endif
 	fs->winsect = sect;				/* Set window to top of the cluster */
 	mem_set(fs->win, 0, sizeof fs->win);	/* Clear window buffer */
 #if FF_USE_LFN == 3		/* Quick table clear by using multi-secter write */
@@ -3286,6 +3536,10 @@ static FRESULT find_volume (	/* FR_OK(0): successful, !=0: an error occurred */
 
 	fs->fs_type = 0;					/* Clear the filesystem object */
 	fs->part_type = 0;					/* Clear the Partition object */
+#if FF_WIN_CACHE_SECTORS
+	if (!fs->wc_buf && LD2PD(vol) != DRIVE_RAM) fs->wc_buf = ff_memalloc(WC_SIZE);	/* Runs without the cache if it fails. Not worth it on a RAM disk */
+	if (fs->wc_buf) wc_reset(fs);
+#endif
 	fs->pdrv = LD2PD(vol);				/* Bind the logical drive and a physical drive */
 	stat = disk_initialize(fs->pdrv);	/* Initialize the physical drive */
 	if (stat & STA_NOINIT) { 			/* Check if the initialization succeeded */
@@ -3592,12 +3846,24 @@ FRESULT f_mount (
 #endif
 #if FF_FS_REENTRANT						/* Discard sync object of the current volume */
 		if (!ff_del_syncobj(cfs->sobj)) return FR_INT_ERR;
+#endif
+#if FF_WIN_CACHE_SECTORS
+		if (cfs->wc_buf) {				/* Release the window cache */
+#if !FF_FS_READONLY
+			if (cfs->fs_type) wc_flush(cfs);
+#endif
+			ff_memfree(cfs->wc_buf);
+			cfs->wc_buf = 0;
+		}
 #endif
 		cfs->fs_type = 0;				/* Clear old fs object */
 	}
 
 	if (fs) {
 		fs->fs_type = 0;				/* Clear new fs object */
+#if FF_WIN_CACHE_SECTORS
+		fs->wc_buf = 0;
+#endif
 #if FF_FS_REENTRANT						/* Create sync object for the new volume */
 		if (!ff_cre_syncobj((BYTE)vol, &fs->sobj)) return FR_INT_ERR;
 #endif
@@ -5033,6 +5299,66 @@ FRESULT f_getfree (
 
 
 
+#if FF_USE_TRIM && !FF_FS_READONLY
+/*-----------------------------------------------------------------------*/
+/* Discard Free Clusters                                                 */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_discard_free (
+	const TCHAR* path,	/* Logical drive number */
+	DWORD* nclst,		/* Pointer to a variable to return number of discarded clusters (can be NULL) */
+	void (*func)(DWORD,DWORD)	/* Progress callback with scanned and total clusters (can be NULL) */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+	DWORD clst, stat, scl, ecl, ndisc;
+	DWORD rt[2];
+	FFOBJID obj;
+
+
+	/* Get logical drive */
+	res = find_volume(&path, &fs, FA_WRITE);
+	if (res == FR_OK) {
+		obj.fs = fs;
+		scl = ecl = ndisc = 0;
+		for (clst = 2; clst < fs->n_fatent; clst++) {
+#if FF_FS_EXFAT
+			if (fs->fs_type == FS_EXFAT) {	/* exFAT: Check allocation bitmap */
+				res = move_window(fs, fs->bitbase + (clst - 2) / 8 / SS(fs));
+				if (res != FR_OK) break;
+				stat = (fs->win[(clst - 2) / 8 % SS(fs)] >> ((clst - 2) % 8)) & 1;
+			} else
+#endif
+			{	/* FAT12/16/32: Check FAT entry */
+				stat = get_fat(&obj, clst);
+				if (stat == 0xFFFFFFFF) { res = FR_DISK_ERR; break; }
+				if (stat == 1) { res = FR_INT_ERR; break; }
+			}
+			if (stat == 0) {	/* Extend the free block */
+				if (scl == 0) scl = clst;
+				ecl = clst;
+			}
+			if (scl != 0 && (stat != 0 || clst == fs->n_fatent - 1)) {	/* End of free block */
+				rt[0] = clst2sect(fs, scl);					/* Start of data area to discard */
+				rt[1] = clst2sect(fs, ecl) + fs->csize - 1;	/* End of data area to discard */
+				if (disk_ioctl(fs->pdrv, CTRL_TRIM, rt) != RES_OK) { res = FR_DISK_ERR; break; }
+				ndisc += ecl - scl + 1;
+				scl = 0;
+				if (func) func(clst, fs->n_fatent);
+			} else if (func && !(clst & 0xFFFF)) {
+				func(clst, fs->n_fatent);
+			}
+		}
+		if (nclst) *nclst = ndisc;
+	}
+
+	LEAVE_FF(fs, res);
+}
+#endif
+
+
+
 
 /*-----------------------------------------------------------------------*/
 /* Truncate File                                                         */
@@ -5986,7 +6312,7 @@ FRESULT f_mkfs (
 					ch = 0xFFFF; st = 2; break;	/* Compress the no-case block if run is >= 128 */
 				}
 				st = 1;			/* Do not compress short run */
-				/* go to next case */
+				/* Fall through - go to next case */
 			case 1:
 				ch = si++;		/* Fill the short run */
 				if (--j == 0) st = 0;
@@ -136,6 +136,13 @@ typedef struct {
 	DWORD	database;		/* Data base sector */
 #if FF_FS_EXFAT
 	DWORD	bitbase;		/* Allocation bitmap base sector */
+#endif
+#if FF_WIN_CACHE_SECTORS
+	BYTE*	wc_buf;			/* Window cache block (sector data, read-ahead buffer and tags) */
+	DWORD	wc_tick;		/* Window cache LRU clock */
+	DWORD	wc_hit;			/* Number of window loads served by the cache */
+	DWORD	wc_miss;		/* Number of window loads read from the disk */
+	DWORD	wc_wback;		/* Number of cached sectors written back */
 #endif
 	DWORD	winsect;		/* Current sector appearing in the win[] */
 	BYTE	win[FF_MAX_SS] __attribute__((aligned(8)));	/* Disk access window for Directory, FAT (and file data at tiny cfg). DMA aligned. */
@@ -284,6 +291,7 @@ FRESULT f_chdir (const TCHAR* path);								/* Change current directory */
 FRESULT f_chdrive (const TCHAR* path);								/* Change current drive */
 FRESULT f_getcwd (TCHAR* buff, UINT len);							/* Get current directory */
 FRESULT f_getfree (const TCHAR* path, DWORD* nclst, FATFS** fatfs);	/* Get number of free clusters on the drive */
+FRESULT f_discard_free (const TCHAR* path, DWORD* nclst, void (*func)(DWORD,DWORD));	/* Discard free clusters on the drive */
 FRESULT f_getlabel (const TCHAR* path, TCHAR* label, DWORD* vsn);	/* Get volume label */
 FRESULT f_setlabel (const TCHAR* label);							/* Set volume label */
 FRESULT f_forward (FIL* fp, UINT(*func)(const BYTE*,UINT), UINT btf, UINT* bf);	/* Forward data to the stream */
@@ -31,6 +31,8 @@
 #  define LV_MEM_ATTR                        /*Complier prefix for big array declaration*/
 #  define LV_MEM_ADR          NYX_LV_MEM_ADR /*Set an address for memory pool instead of allocation it as an array. Can be in external SRAM too.*/
 #  define LV_MEM_AUTO_DEFRAG  1              /*Automatically defrag on free*/
+#  define LV_MEM_SLAB_MAX_SIZE   512         /*Serve allocations up to this size from O(1) size-class slabs (0: disable)*/
+#  define LV_MEM_SLAB_CHUNK_SIZE 0x10000     /*Bytes taken from the pool when a size class runs out of objects*/
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <mem/heap.h> /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
@@ -38,6 +38,13 @@
  *********************/
 #define LV_MEM_ADD_JUNK     0   /*Add memory junk on alloc (0xaa) and free(0xbb) (just for testing purposes)*/
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_MAX_SIZE != 0
+#  define LV_MEM_SLAB         1
+#  define SLAB_CLASS_CNT      (LV_MEM_SLAB_MAX_SIZE / sizeof(lv_mem_header_t))
+#else
+#  define LV_MEM_SLAB         0
+#endif
+
 
 #ifdef LV_MEM_ENV64
 # define MEM_UNIT uint64_t
@@ -57,6 +64,7 @@ typedef union {
     struct {
         MEM_UNIT used: 1;       //1: if the entry is used
         MEM_UNIT d_size: 31;    //Size of the data
+        MEM_UNIT slab;          //Size class + 1 if the entry lives in a slab, 0 if it is a pool entry
     };
     MEM_UNIT header;            //The header (used + d_size)
     MEM_UNIT align[8];          //Align header size to MEM_UNIT * 8 bytes
@@ -78,6 +86,11 @@ typedef struct {
 static lv_mem_ent_t  * ent_get_next(lv_mem_ent_t * act_e);
 static void * ent_alloc(lv_mem_ent_t * e, uint32_t size);
 static void ent_trunc(lv_mem_ent_t * e, uint32_t size);
+static void * pool_alloc(uint32_t size);
+#endif
+#if LV_MEM_SLAB
+static void * slab_alloc(uint32_t size);
+static void slab_free(lv_mem_ent_t * e);
 #endif
 
 /**********************
@@ -87,6 +100,15 @@ static void ent_trunc(lv_mem_ent_t * e, uint32_t size);
 static uint8_t * work_mem;
 #endif
 
+#if LV_MEM_SLAB
+static lv_mem_ent_t * slab_free_list[SLAB_CLASS_CNT]; /*Free objects of each size class*/
+static uint32_t slab_total;     /*Bytes taken from the pool for slab chunks*/
+static uint32_t slab_avail;     /*Bytes (with headers) sitting in the slab free lists*/
+#endif
+
+static uint32_t mem_used;       /*Bytes (with headers) handed out to the user*/
+static uint32_t mem_used_max;   /*Peak of 'mem_used'*/
+
 static uint32_t zero_mem;       /*Give the address of this variable if 0 byte should be allocated*/
 
 /**********************
@@ -114,9 +136,19 @@ void lv_mem_init(void)
 
     lv_mem_ent_t * full = (lv_mem_ent_t *)work_mem;
     full->header.used = 0;
+    full->header.slab = 0;
     /*The total mem size id reduced by the first header and the close patterns */
     full->header.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+
+#if LV_MEM_SLAB
+    memset(slab_free_list, 0, sizeof(slab_free_list));
+    slab_total = 0;
+    slab_avail = 0;
 #endif
+#endif
+
+    mem_used = 0;
+    mem_used_max = 0;
 }
 
 /**
@@ -139,19 +171,12 @@ void * lv_mem_alloc(uint32_t size)
     void * alloc = NULL;
 
 #if LV_MEM_CUSTOM == 0 /*Use the allocation from dyn_mem*/
-    lv_mem_ent_t * e = NULL;
-
-    //Search for a appropriate entry
-    do {
-        //Get the next entry
-        e = ent_get_next(e);
-
-        /*If there is next entry then try to allocate there*/
-        if(e != NULL) {
-            alloc = ent_alloc(e, size);
-        }
-        //End if there is not next entry OR the alloc. is successful
-    } while(e != NULL && alloc == NULL);
+#if LV_MEM_SLAB
+    /*Small objects are served in O(1) from their size class*/
+    if(size <= LV_MEM_SLAB_MAX_SIZE) alloc = slab_alloc(size);
+    if(alloc == NULL)
+#endif
+        alloc = pool_alloc(size);
 
 
 #else  /*Use custom, user defined malloc function*/
@@ -172,6 +197,13 @@ void * lv_mem_alloc(uint32_t size)
     if(alloc != NULL) memset(alloc, 0xaa, size);
 #endif
 
+#if LV_ENABLE_GC == 0
+    if(alloc != NULL) {
+        mem_used += lv_mem_get_size(alloc) + sizeof(lv_mem_header_t);
+        if(mem_used > mem_used_max) mem_used_max = mem_used;
+    }
+#endif
+
     if(alloc == NULL) LV_LOG_WARN("Couldn't allocate memory");
 
     return alloc;
@@ -195,9 +227,18 @@ void lv_mem_free(const void * data)
     /*e points to the header*/
     lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *) data - sizeof(lv_mem_header_t));
     e->header.used = 0;
+    mem_used -= e->header.d_size + sizeof(lv_mem_header_t);
 #endif
 
 #if LV_MEM_CUSTOM == 0
+#if LV_MEM_SLAB
+    /*Slab objects go back to their size class, the pool is not touched*/
+    if(e->header.slab) {
+        slab_free(e);
+        return;
+    }
+#endif
+
 #if LV_MEM_AUTO_DEFRAG
     /* Make a simple defrag.
      * Join the following free entries after this*/
@@ -255,7 +296,12 @@ void * lv_mem_realloc(void * data_p, uint32_t new_size)
      * If the 'old_size' was extended by a header size in 'ent_trunc' it avoids reallocating this same memory */
     if(new_size < old_size) {
         lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *) data_p - sizeof(lv_mem_header_t));
+
+        /*Slab objects have a fixed size, so keep them in their class*/
+        if(e->header.slab) return data_p;
+
         ent_trunc(e, new_size);
+        mem_used -= old_size - e->header.d_size;
         return &e->first_data;
     }
 #endif
@@ -359,9 +405,17 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
         e = ent_get_next(e);
     }
     mon_p->total_size = LV_MEM_SIZE;
+#if LV_MEM_SLAB
+    mon_p->slab_size = slab_total;
+    mon_p->slab_free_size = slab_avail;
+#endif
+    mon_p->used_size = mem_used;
+    mon_p->max_used = mem_used_max;
     mon_p->used_pct = 100 - ((uint64_t)100U * mon_p->free_size) / mon_p->total_size;
-    mon_p->frag_pct = (uint32_t)mon_p->free_biggest_size * 100U / mon_p->free_size;
-    mon_p->frag_pct = 100 - mon_p->frag_pct;
+    if(mon_p->free_size) {
+        mon_p->frag_pct = (uint64_t)mon_p->free_biggest_size * 100U / mon_p->free_size;
+        mon_p->frag_pct = 100 - mon_p->frag_pct;
+    }
 #endif
 }
 
@@ -432,9 +486,10 @@ static void * ent_alloc(lv_mem_ent_t * e, uint32_t size)
     /*If the memory is free and big enough then use it */
     if(e->header.used == 0 && e->header.d_size >= size) {
         /*Truncate the entry to the desired size */
-        ent_trunc(e, size),
+        ent_trunc(e, size);
 
-                  e->header.used = 1;
+        e->header.used = 1;
+        e->header.slab = 0;
 
         /*Save the allocated data*/
         alloc = &e->first_data;
@@ -460,6 +515,7 @@ static void ent_trunc(lv_mem_ent_t * e, uint32_t size)
         uint8_t * e_data = &e->first_data;
         lv_mem_ent_t * after_new_e = (lv_mem_ent_t *)&e_data[size];
         after_new_e->header.used = 0;
+        after_new_e->header.slab = 0;
         after_new_e->header.d_size = e->header.d_size - size - sizeof(lv_mem_header_t);
     }
 
@@ -467,4 +523,83 @@ static void ent_trunc(lv_mem_ent_t * e, uint32_t size)
     e->header.d_size = size;
 }
 
+/**
+ * First-fit allocation from the pool
+ * @param size size of the new memory in bytes (already rounded)
+ * @return pointer to the allocated memory or NULL if no entry is big enough
+ */
+static void * pool_alloc(uint32_t size)
+{
+    void * alloc = NULL;
+    lv_mem_ent_t * e = NULL;
+
+    //Search for a appropriate entry
+    do {
+        //Get the next entry
+        e = ent_get_next(e);
+
+        /*If there is next entry then try to allocate there*/
+        if(e != NULL) {
+            alloc = ent_alloc(e, size);
+        }
+        //End if there is not next entry OR the alloc. is successful
+    } while(e != NULL && alloc == NULL);
+
+    return alloc;
+}
+
+#endif
+
+#if LV_MEM_SLAB
+/**
+ * Allocate an object from its size class.
+ * An empty class is refilled by carving a new chunk out of the pool.
+ * Chunks are never given back, so freed objects are reused by later allocations of the same class.
+ * @param size size of the new memory in bytes (already rounded)
+ * @return pointer to the allocated memory or NULL if the pool is exhausted
+ */
+static void * slab_alloc(uint32_t size)
+{
+    uint32_t cls = size / sizeof(lv_mem_header_t) - 1;
+    lv_mem_ent_t * e = slab_free_list[cls];
+
+    if(e == NULL) {
+        uint32_t obj_size = size + sizeof(lv_mem_header_t);
+        uint32_t obj_cnt = LV_MEM_SLAB_CHUNK_SIZE / obj_size;
+        uint8_t * chunk = pool_alloc(obj_cnt * obj_size);
+        if(chunk == NULL) return NULL;
+
+        /*Thread the new objects into the free list, lowest address first*/
+        for(int32_t i = obj_cnt - 1; i >= 0; i--) {
+            lv_mem_ent_t * obj = (lv_mem_ent_t *)&chunk[i * obj_size];
+            obj->header.used = 0;
+            obj->header.d_size = size;
+            obj->header.slab = cls + 1;
+            *(lv_mem_ent_t **)&obj->first_data = e;
+            e = obj;
+        }
+
+        slab_total += obj_cnt * obj_size + sizeof(lv_mem_header_t);
+        slab_avail += obj_cnt * obj_size;
+    }
+
+    slab_free_list[cls] = *(lv_mem_ent_t **)&e->first_data;
+    slab_avail -= size + sizeof(lv_mem_header_t);
+    e->header.used = 1;
+
+    return &e->first_data;
+}
+
+/**
+ * Give back a slab object to its size class
+ * @param e pointer to the entry of the object
+ */
+static void slab_free(lv_mem_ent_t * e)
+{
+    uint32_t cls = e->header.slab - 1;
+
+    *(lv_mem_ent_t **)&e->first_data = slab_free_list[cls];
+    slab_free_list[cls] = e;
+    slab_avail += e->header.d_size + sizeof(lv_mem_header_t);
+}
 #endif
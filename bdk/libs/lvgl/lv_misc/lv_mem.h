@@ -50,6 +50,10 @@ typedef struct
     uint32_t free_size;
     uint32_t free_biggest_size;
     uint32_t used_cnt;
+    uint32_t used_size;         /*Bytes currently allocated (with headers)*/
+    uint32_t max_used;          /*Peak of 'used_size' since init*/
+    uint32_t slab_size;         /*Bytes of the pool given to size-class slabs*/
+    uint32_t slab_free_size;    /*Bytes free inside the slabs*/
     uint8_t used_pct;
     uint8_t frag_pct;
 } lv_mem_monitor_t;
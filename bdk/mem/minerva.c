@@ -18,6 +18,7 @@
 #include <stdlib.h>
 
 #include "minerva.h"
+#include "minerva_cache.h"
 
 #include <soc/clock.h>
 #include <ianos/ianos.h>
@@ -31,6 +32,15 @@ extern volatile nyx_storage_t *nyx_str;
 
 void (*minerva_cfg)(mtc_config_t *mtc_cfg, void *);
 
+static void _minerva_cache_key_init(mtc_cache_hdr_t *key, mtc_config_t *mtc_cfg)
+{
+	u32 ecid[4];
+	u32 table_crc = crc32_calc(0, (u8 *)mtc_cfg->mtc_table, mtc_cfg->table_entries * sizeof(emc_table_t));
+
+	fuse_read_ecid(ecid);
+	minerva_cache_key_init(key, mtc_cfg->sdram_id, hw_get_chip_id(), ecid, table_crc, mtc_cfg->table_entries);
+}
+
 u32 minerva_init()
 {
 	u32 curr_ram_idx = 0;
@@ -93,9 +103,17 @@ u32 minerva_init()
 		mtc_cfg->init_done = 0;
 #endif
 
-	if (!minerva_cfg)
+	if (!minerva_cfg || mtc_cfg->table_entries > 10)
 		return 1;
 
+	// Reuse previous training results if valid. Trained entries skip pattern training.
+	// There is no retraining on the reused results beyond the periodic compensation
+	// that runs on the switch to max frequency, so the cache expires after
+	// MTC_CACHE_MAX_AGE cold boots and the DRAM gets fully trained again.
+	mtc_cache_hdr_t cache_key;
+	_minerva_cache_key_init(&cache_key, mtc_cfg);
+	bool cached = minerva_cache_load(&cache_key, mtc_cfg->mtc_table);
+
 	// Get current frequency
 	for (curr_ram_idx = 0; curr_ram_idx < 10; curr_ram_idx++)
 	{
@@ -121,6 +139,9 @@ u32 minerva_init()
 	mtc_cfg->rate_to = FREQ_1600;
 	minerva_cfg(mtc_cfg, NULL);
 
+	if (!cached)
+		minerva_cache_save(&cache_key, mtc_cfg->mtc_table);
+
 	return 0;
 }
 
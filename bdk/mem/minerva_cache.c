@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "minerva_cache.h"
+
+#include <libs/fatfs/ff.h>
+#include <mem/heap.h>
+#include <utils/util.h>
+
+void minerva_cache_key_init(mtc_cache_hdr_t *key, u32 sdram_id, u32 chip_id, const u32 *ecid, u32 table_crc, u32 entries)
+{
+	memset(key, 0, sizeof(mtc_cache_hdr_t));
+
+	key->magic     = MTC_CACHE_MAGIC;
+	key->sdram_id  = sdram_id;
+	key->chip_id   = chip_id;
+	memcpy(key->ecid, ecid, sizeof(key->ecid));
+	key->table_crc = table_crc;
+	key->entries   = entries;
+}
+
+bool minerva_cache_load(const mtc_cache_hdr_t *key, emc_table_t *table)
+{
+	FIL fp;
+	UINT br;
+	mtc_cache_hdr_t hdr;
+	bool res = false;
+	u32 size = key->entries * sizeof(emc_table_t);
+
+	if (f_open(&fp, MTC_CACHE_PATH, FA_READ | FA_WRITE))
+		return false;
+
+	emc_table_t *cached = (emc_table_t *)malloc(size);
+
+	// Must match this console, DRAM and Minerva table, and the trained table must be intact.
+	if (f_size(&fp) == sizeof(mtc_cache_hdr_t) + size &&
+		!f_read(&fp, &hdr, sizeof(mtc_cache_hdr_t), &br) && br == sizeof(mtc_cache_hdr_t) &&
+		!memcmp(&hdr, key, offsetof(mtc_cache_hdr_t, crc)) &&
+		hdr.age < MTC_CACHE_MAX_AGE &&
+		!f_read(&fp, cached, size, &br) && br == size &&
+		crc32_calc(0, (u8 *)cached, size) == hdr.crc)
+	{
+		// Count the boot. If that can't be stored, retrain instead of using a cache that never expires.
+		hdr.age++;
+		if (!f_lseek(&fp, 0) && !f_write(&fp, &hdr, sizeof(mtc_cache_hdr_t), &br) && br == sizeof(mtc_cache_hdr_t))
+		{
+			memcpy(table, cached, size);
+			res = true;
+		}
+	}
+
+	free(cached);
+	f_close(&fp);
+
+	return res;
+}
+
+bool minerva_cache_save(const mtc_cache_hdr_t *key, const emc_table_t *table)
+{
+	FIL fp;
+	UINT bw;
+	mtc_cache_hdr_t hdr;
+	u32 size = key->entries * sizeof(emc_table_t);
+
+	memcpy(&hdr, key, sizeof(mtc_cache_hdr_t));
+	hdr.crc = crc32_calc(0, (u8 *)table, size);
+	hdr.age = 0;
+
+	if (f_open(&fp, MTC_CACHE_PATH, FA_CREATE_ALWAYS | FA_WRITE))
+		return false;
+
+	bool ok = !f_write(&fp, &hdr, sizeof(mtc_cache_hdr_t), &bw) && bw == sizeof(mtc_cache_hdr_t) &&
+		!f_write(&fp, table, size, &bw) && bw == size;
+	f_close(&fp);
+
+	if (!ok)
+		f_unlink(MTC_CACHE_PATH);
+
+	return ok;
+}
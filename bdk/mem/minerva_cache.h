@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MINERVA_CACHE_H_
+#define _MINERVA_CACHE_H_
+
+#include "mtc_table.h"
+#include <utils/types.h>
+
+#define MTC_CACHE_PATH    "bootloader/sys/minerva_train.bin"
+#define MTC_CACHE_MAGIC   0x4354544D // "MTTC".
+#define MTC_CACHE_MAX_AGE 64         // Cold boots served from a cache before a full retrain.
+
+/*
+ * File layout: mtc_cache_hdr_t, then the trained emc_table_t entries.
+ * Everything before crc is the key and must match the running console.
+ */
+typedef struct _mtc_cache_hdr_t
+{
+	u32 magic;
+	u32 sdram_id;
+	u32 chip_id;
+	u32 ecid[4];   // Fuse ECID. Training results are specific to one SoC and DRAM.
+	u32 table_crc; // Untrained table as provided by Minerva. Changes with the module.
+	u32 entries;
+	u32 crc;       // Trained table.
+	u32 age;       // Cold boots served from this cache.
+} mtc_cache_hdr_t;
+
+void minerva_cache_key_init(mtc_cache_hdr_t *key, u32 sdram_id, u32 chip_id, const u32 *ecid, u32 table_crc, u32 entries);
+bool minerva_cache_load(const mtc_cache_hdr_t *key, emc_table_t *table);
+bool minerva_cache_save(const mtc_cache_hdr_t *key, const emc_table_t *table);
+
+#endif
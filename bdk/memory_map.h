@@ -95,6 +95,10 @@
 #define NYX_FB2_ADDRESS  0xF6600000
 #define  NYX_FB_SZ         0x384000 // 1280 x 720 x 4.
 
+// SDMMC ADMA2 descriptor tables.
+#define SDMMC_ADMA_ADDR  0xF6990000
+#define  SDMMC_ADMA_SZ      0x10000 // 4 x 16KB.
+
 #define DRAM_MEM_HOLE_ADR 0xF6A00000
 #define DRAM_MEM_HOLE_SZ   0x8140000
 /* ---   Hole: 129MB 0xF6A00000 - 0xFEB3FFFF --- */
@@ -95,7 +95,17 @@ static int _se_execute(u32 op, void *dst, u32 dst_size, const void *src, u32 src
 	SE(SE_ERR_STATUS_REG) = SE(SE_ERR_STATUS_REG);
 	SE(SE_INT_STATUS_REG) = SE(SE_INT_STATUS_REG);
 
-	bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+	// Flush only the linked lists and buffers used by the operation.
+	if (src)
+	{
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_PHY, ll_src, sizeof(se_ll_t));
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_PHY, src, src_size);
+	}
+	if (dst)
+	{
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_PHY, ll_dst, sizeof(se_ll_t));
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, dst, dst_size);
+	}
 
 	SE(SE_OPERATION_REG) = op;
 
@@ -103,7 +113,8 @@ static int _se_execute(u32 op, void *dst, u32 dst_size, const void *src, u32 src
 	{
 		int res = _se_wait();
 
-		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+		if (dst)
+			bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, dst, dst_size);
 
 		if (src)
 			free(ll_src);
@@ -120,7 +131,8 @@ static int _se_execute_finalize()
 {
 	int res = _se_wait();
 
-	bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+	if (ll_dst)
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, (void *)ll_dst->addr, ll_dst->size);
 
 	if (ll_src)
 	{
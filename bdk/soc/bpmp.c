@@ -140,6 +140,43 @@ void bpmp_mmu_maintenance(u32 op, bool force)
 	BPMP_CACHE_CTRL(BPMP_CACHE_INT_CLEAR) = BPMP_CACHE_CTRL(BPMP_CACHE_INT_RAW_EVENT);
 }
 
+/*
+ * Line based maintenance by physical address. Op must be one of the *_PHY ops.
+ * Only lines of the range are affected, so the rest of the cache stays hot.
+ */
+void bpmp_mmu_maintenance_range(u32 op, const void *addr, u32 size)
+{
+	if (!size || !(BPMP_CACHE_CTRL(BPMP_CACHE_CONFIG) & CFG_ENABLE_CACHE))
+		return;
+
+	u32 line = ALIGN_DOWN((u32)addr, BPMP_MMU_CACHE_LINE_SIZE);
+	u32 lines = (ALIGN((u32)addr + size, BPMP_MMU_CACHE_LINE_SIZE) - line) / BPMP_MMU_CACHE_LINE_SIZE;
+
+	// Walking all ways is faster than issuing that many line requests.
+	if (lines * BPMP_MMU_CACHE_LINE_SIZE > BPMP_MMU_MAINT_RANGE_MAX)
+	{
+		bpmp_mmu_maintenance(op + (BPMP_MMU_MAINT_CLEAN_WAY - BPMP_MMU_MAINT_CLEAN_PHY), false);
+		return;
+	}
+
+	while (lines)
+	{
+		BPMP_CACHE_CTRL(BPMP_CACHE_INT_CLEAR) = INT_MAINT_DONE;
+
+		// This is a blocking operation.
+		BPMP_CACHE_CTRL(BPMP_CACHE_MAINT_ADDR) = line;
+		BPMP_CACHE_CTRL(BPMP_CACHE_MAINT_REQ) = MAINT_REQ_WAY_BITMAP(0xF) | op;
+
+		while(!(BPMP_CACHE_CTRL(BPMP_CACHE_INT_RAW_EVENT) & INT_MAINT_DONE))
+			;
+
+		line += BPMP_MMU_CACHE_LINE_SIZE;
+		lines--;
+	}
+
+	BPMP_CACHE_CTRL(BPMP_CACHE_INT_CLEAR) = BPMP_CACHE_CTRL(BPMP_CACHE_INT_RAW_EVENT);
+}
+
 void bpmp_mmu_set_entry(int idx, bpmp_mmu_entry_t *entry, bool apply)
 {
 	if (idx > 31)
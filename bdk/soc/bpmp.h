@@ -55,7 +55,10 @@ typedef enum
 
 #define BPMP_CLK_DEFAULT_BOOST BPMP_CLK_HYPER_BOOST
 
+#define BPMP_MMU_MAINT_RANGE_MAX 0x4000 // Bigger ranges use way based maintenance.
+
 void bpmp_mmu_maintenance(u32 op, bool force);
+void bpmp_mmu_maintenance_range(u32 op, const void *addr, u32 size);
 void bpmp_mmu_set_entry(int idx, bpmp_mmu_entry_t *entry, bool apply);
 void bpmp_mmu_enable();
 void bpmp_mmu_disable();
@@ -97,6 +97,16 @@ u32 fuse_read_dramid(bool raw_id)
 	return dramid;
 }
 
+void fuse_read_ecid(u32 *ecid)
+{
+	// Vendor, fab, lot, wafer and die coordinates. Unique per SoC.
+	ecid[0] = FUSE(FUSE_OPT_LOT_CODE_0);
+	ecid[1] = FUSE(FUSE_OPT_LOT_CODE_1) & 0xFFFFFFF;
+	ecid[2] = (FUSE(FUSE_OPT_VENDOR_CODE) & 0xF) | ((FUSE(FUSE_OPT_FAB_CODE) & 0x3F) << 4) |
+		((FUSE(FUSE_OPT_WAFER_ID) & 0x3F) << 10);
+	ecid[3] = (FUSE(FUSE_OPT_X_COORDINATE) & 0x1FF) | ((FUSE(FUSE_OPT_Y_COORDINATE) & 0x1FF) << 9);
+}
+
 u32 fuse_read_hw_state()
 {
 	if ((fuse_read_odm(4) & 3) != 3)
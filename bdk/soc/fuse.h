@@ -95,6 +95,7 @@ void fuse_disable_program();
 u32  fuse_read_odm(u32 idx);
 u32  fuse_read_odm_keygen_rev();
 u32  fuse_read_dramid(bool raw_id);
+void fuse_read_ecid(u32 *ecid);
 u32  fuse_read_hw_state();
 u32  fuse_read_hw_type();
 u8   fuse_count_burnt(u32 val);
@@ -221,6 +221,16 @@ c : clear by read
 /* (11) Reserved */
 /* (CMD?) */
 
+/*
+ * CMD23 (SET_BLOCK_COUNT) argument flags and packed command header
+ */
+#define MMC_CMD23_ARG_REL_WR  (1U << 31)
+#define MMC_CMD23_ARG_PACKED  (1 << 30)
+#define MMC_CMD23_ARG_TAG_REQ (1 << 29)
+
+#define PACKED_CMD_VER 0x01
+#define PACKED_CMD_WR  0x02
+
 /*
 * CSD field definitions
 */
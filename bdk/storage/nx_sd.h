@@ -40,7 +40,11 @@ enum
 
 extern sdmmc_t sd_sdmmc;
 extern sdmmc_storage_t sd_storage;
+#ifdef NYX
 extern FATFS sd_fs;
+#else
+extern FATFS *sd_fs; // In DRAM, so its window is not bounced.
+#endif
 
 void sd_error_count_increment(u8 type);
 u16 *sd_get_error_count();
@@ -54,6 +58,7 @@ void sd_unmount();
 void sd_end();
 bool sd_is_gpt();
 void *sd_file_read(const char *path, u32 *fsize);
+void *sd_file_read_lz4c(const char *path, u32 *fsize);
 int  sd_save_to_file(void *buf, u32 size, const char *filename);
 
 #endif
\ No newline at end of file
@@ -139,24 +139,47 @@ static int _sdmmc_storage_check_status(sdmmc_storage_t *storage)
 	return _sdmmc_storage_get_status(storage, &tmp, 0);
 }
 
-static int _sdmmc_storage_readwrite_ex(sdmmc_storage_t *storage, u32 *blkcnt_out, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+static int _sdmmc_storage_wait_tran_state(sdmmc_storage_t *storage, u32 timeout_ms)
 {
-	u32 tmp = 0;
-	sdmmc_cmd_t cmdbuf;
-	sdmmc_req_t reqbuf;
+	u32 timeout = get_tmr_ms() + timeout_ms;
+	while (!_sdmmc_storage_check_status(storage))
+	{
+		if (get_tmr_ms() > timeout)
+			return 0;
 
+		msleep(1);
+	}
+
+	return 1;
+}
+
+static void _sdmmc_storage_init_rw(sdmmc_storage_t *storage, sdmmc_cmd_t *cmdbuf, sdmmc_req_t *reqbuf, u32 sector, u32 num_sectors, void *buf, u32 sg_cnt, u32 is_write)
+{
 	// If SDSC convert block address to byte address.
 	if (!storage->has_sector_access)
 		sector <<= 9;
 
-	sdmmc_init_cmd(&cmdbuf, is_write ? MMC_WRITE_MULTIPLE_BLOCK : MMC_READ_MULTIPLE_BLOCK, sector, SDMMC_RSP_TYPE_1, 0);
+	sdmmc_init_cmd(cmdbuf, is_write ? MMC_WRITE_MULTIPLE_BLOCK : MMC_READ_MULTIPLE_BLOCK, sector, SDMMC_RSP_TYPE_1, 0);
 
-	reqbuf.buf = buf;
-	reqbuf.num_sectors = num_sectors;
-	reqbuf.blksize = 512;
-	reqbuf.is_write = is_write;
-	reqbuf.is_multi_block = 1;
-	reqbuf.is_auto_stop_trn = 1;
+	reqbuf->buf = buf;
+	reqbuf->sg_cnt = sg_cnt;
+	reqbuf->num_sectors = num_sectors;
+	reqbuf->blksize = 512;
+	reqbuf->is_write = is_write;
+	reqbuf->is_multi_block = 1;
+
+	// Pre-define block count if supported, so no stop transmission is needed.
+	reqbuf->is_auto_stop_trn = !storage->has_cmd23;
+	reqbuf->is_auto_set_blkcnt = storage->has_cmd23;
+}
+
+static int _sdmmc_storage_readwrite_ex(sdmmc_storage_t *storage, u32 *blkcnt_out, u32 sector, u32 num_sectors, void *buf, u32 sg_cnt, u32 is_write)
+{
+	u32 tmp = 0;
+	sdmmc_cmd_t cmdbuf;
+	sdmmc_req_t reqbuf;
+
+	_sdmmc_storage_init_rw(storage, &cmdbuf, &reqbuf, sector, num_sectors, buf, sg_cnt, is_write);
 
 	if (!sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, blkcnt_out))
 	{
@@ -171,6 +194,12 @@ static int _sdmmc_storage_readwrite_ex(sdmmc_storage_t *storage, u32 *blkcnt_out
 
 int sdmmc_storage_end(sdmmc_storage_t *storage)
 {
+	// Volatile cache contents are lost on CMD0 and power off.
+	if (storage->initialized && !sdmmc_storage_flush_mmc_cache(storage))
+	{
+DPRINTF("[MMC] cache flush failed\n");
+	}
+
 	if (!_sdmmc_storage_go_idle_state(storage))
 		return 0;
 
@@ -181,7 +210,7 @@ int sdmmc_storage_end(sdmmc_storage_t *storage)
 	return 1;
 }
 
-static int _sdmmc_storage_readwrite(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+static int _sdmmc_storage_readwrite(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 sg_cnt, u32 is_write)
 {
 	u8 *bbuf = (u8 *)buf;
 	u32 sct_off = sector;
@@ -200,7 +229,7 @@ static int _sdmmc_storage_readwrite(sdmmc_storage_t *storage, u32 sector, u32 nu
 		do
 		{
 reinit_try:
-			if (_sdmmc_storage_readwrite_ex(storage, &blkcnt, sct_off, MIN(sct_total, 0xFFFF), bbuf, is_write))
+			if (_sdmmc_storage_readwrite_ex(storage, &blkcnt, sct_off, MIN(sct_total, 0xFFFF), bbuf, sg_cnt, is_write))
 				goto out;
 			else
 				retries--;
@@ -254,36 +283,259 @@ out:
 	return 1;
 }
 
+static int _sdmmc_storage_readwrite_bounce(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+{
+	u8 *bbuf = (u8 *)buf;
+	u8 *tmp_buf = (u8 *)SDMMC_UPPER_BUFFER;
+
+	storage->bounce_cnt++;
+	storage->bounce_bytes += (u64)num_sectors * 512;
+
+	// Bounce in chunks, so requests bigger than the buffer are not rejected.
+	while (num_sectors)
+	{
+		u32 num = MIN(num_sectors, SDMMC_UP_BUF_SZ / 512);
+
+		if (is_write)
+			memcpy(tmp_buf, bbuf, 512 * num);
+
+		if (!_sdmmc_storage_readwrite(storage, sector, num, tmp_buf, 0, is_write))
+			return 0;
+
+		if (!is_write)
+			memcpy(bbuf, tmp_buf, 512 * num);
+
+		sector += num;
+		num_sectors -= num;
+		bbuf += 512 * num;
+	}
+
+	return 1;
+}
+
 int sdmmc_storage_read(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf)
 {
 	// Ensure that buffer resides in DRAM and it's DMA aligned.
 	if (((u32)buf >= DRAM_START) && !((u32)buf % 8))
-		return _sdmmc_storage_readwrite(storage, sector, num_sectors, buf, 0);
+		return _sdmmc_storage_readwrite(storage, sector, num_sectors, buf, 0, 0);
+
+	return _sdmmc_storage_readwrite_bounce(storage, sector, num_sectors, buf, 0);
+}
+
+int sdmmc_storage_write(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf)
+{
+	// Ensure that buffer resides in DRAM and it's DMA aligned.
+	if (((u32)buf >= DRAM_START) && !((u32)buf % 8))
+		return _sdmmc_storage_readwrite(storage, sector, num_sectors, buf, 0, 1);
+
+	return _sdmmc_storage_readwrite_bounce(storage, sector, num_sectors, buf, 1);
+}
+
+static int _sdmmc_storage_readwrite_sg(sdmmc_storage_t *storage, u32 sector, sdmmc_sg_t *sg, u32 sg_cnt, u32 is_write)
+{
+	u32 size = 0;
 
-	if (num_sectors > (SDMMC_UP_BUF_SZ / 512))
+	// Segments are mapped directly by ADMA2, so they must be in DRAM and DMA aligned.
+	for (u32 i = 0; i < sg_cnt; i++)
+	{
+		if (((u32)sg[i].buf < DRAM_START) || ((u32)sg[i].buf % 8) || (sg[i].size % 8))
+			return 0;
+		size += sg[i].size;
+	}
+
+	// Whole list must be sector aligned and fit in a single transfer.
+	if (!sg_cnt || (size % 512) || (size / 512) > 0xFFFF)
 		return 0;
 
-	u8 *tmp_buf = (u8 *)SDMMC_UPPER_BUFFER;
-	if (_sdmmc_storage_readwrite(storage, sector, num_sectors, tmp_buf, 0))
+	return _sdmmc_storage_readwrite(storage, sector, size / 512, sg, sg_cnt, is_write);
+}
+
+int sdmmc_storage_read_sg(sdmmc_storage_t *storage, u32 sector, sdmmc_sg_t *sg, u32 sg_cnt)
+{
+	return _sdmmc_storage_readwrite_sg(storage, sector, sg, sg_cnt, 0);
+}
+
+int sdmmc_storage_write_sg(sdmmc_storage_t *storage, u32 sector, sdmmc_sg_t *sg, u32 sg_cnt)
+{
+	return _sdmmc_storage_readwrite_sg(storage, sector, sg, sg_cnt, 1);
+}
+
+/*
+ * Asynchronous read/write. The transfer runs in the background after submit and
+ * sdmmc_poll(storage->sdmmc) can be used to check for completion. This allows
+ * driving SD and eMMC at the same time. No retries are done, so on failure the
+ * caller is expected to fall back to the synchronous functions.
+ */
+int sdmmc_storage_submit_rw(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+{
+	sdmmc_cmd_t cmdbuf;
+	sdmmc_req_t reqbuf;
+
+	// Exit if not initialized.
+	if (!storage->initialized)
+		return 0;
+
+	// Buffer must reside in DRAM and be DMA aligned. Transfer must fit in one request.
+	if (((u32)buf < DRAM_START) || ((u32)buf % 8) || !num_sectors || num_sectors > 0xFFFF)
+		return 0;
+
+	_sdmmc_storage_init_rw(storage, &cmdbuf, &reqbuf, sector, num_sectors, buf, 0, is_write);
+
+	return sdmmc_submit_rw(storage->sdmmc, &cmdbuf, &reqbuf);
+}
+
+int sdmmc_storage_wait_rw(sdmmc_storage_t *storage)
+{
+	u32 tmp = 0;
+
+	if (!sdmmc_wait(storage->sdmmc, NULL))
 	{
-		memcpy(buf, tmp_buf, 512 * num_sectors);
-		return 1;
+		sdmmc_stop_transmission(storage->sdmmc, &tmp);
+		_sdmmc_storage_get_status(storage, &tmp, 0);
+
+		return 0;
 	}
-	return 0;
+
+	return 1;
 }
 
-int sdmmc_storage_write(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf)
+static int _mmc_storage_write_packed(sdmmc_storage_t *storage, sdmmc_packed_wr_t *wr, u32 wr_cnt, u32 total_sectors)
 {
-	// Ensure that buffer resides in DRAM and it's DMA aligned.
-	if (((u32)buf >= DRAM_START) && !((u32)buf % 8))
-		return _sdmmc_storage_readwrite(storage, sector, num_sectors, buf, 1);
+	int res = 0;
+	u32 tmp = 0;
+	sdmmc_cmd_t cmdbuf;
+	sdmmc_req_t reqbuf;
+	u32 *hdr = (u32 *)calloc(512, 1);
+	sdmmc_sg_t *sg = (sdmmc_sg_t *)malloc(sizeof(sdmmc_sg_t) * (wr_cnt + 1));
+
+	// Header block describes each write with its CMD23 and CMD25 arguments.
+	hdr[0] = (wr_cnt << 16) | (PACKED_CMD_WR << 8) | PACKED_CMD_VER;
+	sg[0].buf = hdr;
+	sg[0].size = 512;
+	for (u32 i = 0; i < wr_cnt; i++)
+	{
+		hdr[(i + 1) * 2]     = wr[i].num_sectors;
+		hdr[(i + 1) * 2 + 1] = storage->has_sector_access ? wr[i].sector : (wr[i].sector << 9);
+
+		sg[i + 1].buf = wr[i].buf;
+		sg[i + 1].size = wr[i].num_sectors * 512;
+	}
+
+	// Set packed block count. Header and data are then sent as one multi-block write.
+	if (!_sdmmc_storage_execute_cmd_type1(storage, MMC_SET_BLOCK_COUNT, MMC_CMD23_ARG_PACKED | total_sectors, 0, R1_STATE_TRAN))
+		goto out;
+
+	_sdmmc_storage_init_rw(storage, &cmdbuf, &reqbuf, wr[0].sector, total_sectors, sg, wr_cnt + 1, 1);
+	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
+
+	res = sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, NULL);
+	if (!res)
+	{
+		sdmmc_stop_transmission(storage->sdmmc, &tmp);
+		_sdmmc_storage_get_status(storage, &tmp, 0);
+	}
+
+out:
+	free(sg);
+	free(hdr);
+
+	return res;
+}
+
+/*
+ * Write a batch of small scattered requests. On eMMC 4.5 and up, they are sent as a
+ * single packed command, saving the command and busy overhead of each one.
+ * Otherwise, or if packing fails, each entry is written separately.
+ */
+int sdmmc_storage_write_packed(sdmmc_storage_t *storage, sdmmc_packed_wr_t *wr, u32 wr_cnt)
+{
+	u32 total_sectors = 1; // Header.
+	bool can_pack = storage->has_cmd23 && wr_cnt > 1 && wr_cnt <= storage->ext_csd.max_packed_wr;
+
+	// Buffers are mapped directly by ADMA2, so they must be in DRAM and DMA aligned.
+	for (u32 i = 0; i < wr_cnt && can_pack; i++)
+	{
+		if (((u32)wr[i].buf < DRAM_START) || ((u32)wr[i].buf % 8))
+			can_pack = false;
+		total_sectors += wr[i].num_sectors;
+	}
+
+	if (can_pack && total_sectors <= 0xFFFF && storage->initialized)
+	{
+		if (_mmc_storage_write_packed(storage, wr, wr_cnt, total_sectors))
+			return 1;
+	}
 
-	if (num_sectors > (SDMMC_UP_BUF_SZ / 512))
+	for (u32 i = 0; i < wr_cnt; i++)
+	{
+		if (!sdmmc_storage_write(storage, wr[i].sector, wr[i].num_sectors, wr[i].buf))
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Inform the card that a range of sectors is no longer used.
+ * SD uses DISCARD if supported and ERASE otherwise. eMMC uses DISCARD on 4.5 and up and TRIM otherwise,
+ * so no erase group alignment is needed.
+ */
+int sdmmc_storage_discard(sdmmc_storage_t *storage, u32 sector, u32 num_sectors)
+{
+	u32 cmd_start = SD_ERASE_WR_BLK_START;
+	u32 cmd_end = SD_ERASE_WR_BLK_END;
+	u32 arg = storage->ssr.discard ? SD_DISCARD_ARG : SD_ERASE_ARG;
+
+	// Exit if not initialized.
+	if (!storage->initialized || !num_sectors || sector + num_sectors > storage->sec_cnt)
 		return 0;
 
-	u8 *tmp_buf = (u8 *)SDMMC_UPPER_BUFFER;
-	memcpy(tmp_buf, buf, 512 * num_sectors);
-	return _sdmmc_storage_readwrite(storage, sector, num_sectors, tmp_buf, 1);
+	if (storage->sdmmc->id != SDMMC_1)
+	{
+		if (storage->ext_csd.rev >= 6)
+			arg = MMC_DISCARD_ARG;
+		else if (storage->ext_csd.sec_feature & EXT_CSD_SEC_GB_CL_EN)
+			arg = MMC_TRIM_ARG;
+		else
+			return 0;
+
+		cmd_start = MMC_ERASE_GROUP_START;
+		cmd_end = MMC_ERASE_GROUP_END;
+	}
+
+	while (num_sectors)
+	{
+		// Limit each command, so busy time stays reasonable.
+		u32 sct_start = sector;
+		u32 sct_end = sector + MIN(num_sectors, SDMMC_DISCARD_MAX_SECTORS) - 1;
+
+		// If SDSC convert block address to byte address.
+		if (!storage->has_sector_access)
+		{
+			sct_start <<= 9;
+			sct_end <<= 9;
+		}
+
+		if (!_sdmmc_storage_execute_cmd_type1(storage, cmd_start, sct_start, 0, R1_STATE_TRAN))
+			return 0;
+
+		if (!_sdmmc_storage_execute_cmd_type1(storage, cmd_end, sct_end, 0, R1_STATE_TRAN))
+			return 0;
+
+		// Erase can outlast the busy timeout, so don't wait on busy here.
+		// Response errors fail right away, otherwise wait for the card to go back to transfer state.
+		if (!_sdmmc_storage_execute_cmd_type1(storage, MMC_ERASE, arg, 0, R1_SKIP_STATE_CHECK))
+			return 0;
+
+		if (!_sdmmc_storage_wait_tran_state(storage, 30000))
+			return 0;
+
+		sector += MIN(num_sectors, SDMMC_DISCARD_MAX_SECTORS);
+		num_sectors -= MIN(num_sectors, SDMMC_DISCARD_MAX_SECTORS);
+	}
+
+	return 1;
 }
 
 /*
@@ -426,12 +678,17 @@ static void _mmc_storage_parse_ext_csd(sdmmc_storage_t *storage, u8 *buf)
 		(buf[EXT_CSD_CACHE_SIZE + 1] << 8)  |
 		(buf[EXT_CSD_CACHE_SIZE + 2] << 16) |
 		(buf[EXT_CSD_CACHE_SIZE + 3] << 24);
+	storage->ext_csd.cache_ctrl = buf[EXT_CSD_CACHE_CTRL];
+	storage->ext_csd.sec_feature = buf[EXT_CSD_SEC_FEATURE_SUPPORT];
 	storage->ext_csd.max_enh_mult =
 		(buf[EXT_CSD_MAX_ENH_SIZE_MULT]             |
 		(buf[EXT_CSD_MAX_ENH_SIZE_MULT + 1] << 8)   |
 		(buf[EXT_CSD_MAX_ENH_SIZE_MULT + 2] << 16)) *
 		buf[EXT_CSD_HC_WP_GRP_SIZE] * buf[EXT_CSD_HC_ERASE_GRP_SIZE];
 
+	if (storage->ext_csd.rev >= 6) // eMMC 4.5 and up.
+		storage->ext_csd.max_packed_wr = MIN(buf[EXT_CSD_MAX_PACKED_WRITES], SDMMC_PACKED_WR_MAX_ENTRIES);
+
 	storage->sec_cnt = *(u32 *)&buf[EXT_CSD_SEC_CNT];
 }
 
@@ -442,11 +699,13 @@ static int _mmc_storage_get_ext_csd(sdmmc_storage_t *storage, void *buf)
 
 	sdmmc_req_t reqbuf;
 	reqbuf.buf = buf;
+	reqbuf.sg_cnt = 0;
 	reqbuf.blksize = 512;
 	reqbuf.num_sectors = 1;
 	reqbuf.is_write = 0;
 	reqbuf.is_multi_block = 0;
 	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
 
 	if (!sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, NULL))
 		return 0;
@@ -643,6 +902,9 @@ DPRINTF("[MMC] switched buswidth\n");
 DPRINTF("[MMC] got ext_csd\n");
 
 	_mmc_storage_parse_cid(storage); // This needs to be after csd and ext_csd.
+
+	// All eMMC 4.0 and up support pre-defined multi-block transfers.
+	storage->has_cmd23 = 1;
 	//gfx_hexdump(0, ext_csd, 512);
 
 /*
@@ -677,6 +939,39 @@ int sdmmc_storage_set_mmc_partition(sdmmc_storage_t *storage, u32 partition)
 	return 1;
 }
 
+int sdmmc_storage_flush_mmc_cache(sdmmc_storage_t *storage)
+{
+	if (!(storage->ext_csd.cache_ctrl & 1))
+		return 1;
+
+	// Flushing a big cache can outlast the busy timeout, so don't wait on busy here.
+	// Response errors fail right away, otherwise wait for the card to go back to transfer state.
+	if (!_sdmmc_storage_execute_cmd_type1(storage, MMC_SWITCH, SDMMC_SWITCH(MMC_SWITCH_MODE_WRITE_BYTE, EXT_CSD_FLUSH_CACHE, 1), 0, R1_SKIP_STATE_CHECK))
+		return 0;
+
+	return _sdmmc_storage_wait_tran_state(storage, 30000);
+}
+
+int sdmmc_storage_set_mmc_cache(sdmmc_storage_t *storage, u32 enable)
+{
+	// Cache is only available on eMMC 4.5 and up.
+	if (!storage->ext_csd.cache_size)
+		return 0;
+
+	if (!enable && !sdmmc_storage_flush_mmc_cache(storage))
+		return 0;
+
+	if (!_mmc_storage_switch(storage, SDMMC_SWITCH(MMC_SWITCH_MODE_WRITE_BYTE, EXT_CSD_CACHE_CTRL, enable ? 1 : 0)))
+		return 0;
+
+	if (!_sdmmc_storage_check_status(storage))
+		return 0;
+
+	storage->ext_csd.cache_ctrl = enable ? 1 : 0;
+
+	return 1;
+}
+
 /*
  * SD specific functions.
  */
@@ -831,6 +1126,8 @@ static void _sd_storage_parse_scr(sdmmc_storage_t *storage)
 		storage->scr.sda_spec3 = unstuff_bits(resp, 47, 1);
 	if (storage->scr.sda_spec3)
 		storage->scr.cmds = unstuff_bits(resp, 32, 2);
+
+	storage->has_cmd23 = !!(storage->scr.cmds & SD_SCR_CMD23_SUPPORT);
 }
 
 int _sd_storage_get_scr(sdmmc_storage_t *storage, u8 *buf)
@@ -840,11 +1137,13 @@ int _sd_storage_get_scr(sdmmc_storage_t *storage, u8 *buf)
 
 	sdmmc_req_t reqbuf;
 	reqbuf.buf = buf;
+	reqbuf.sg_cnt = 0;
 	reqbuf.blksize = 8;
 	reqbuf.num_sectors = 1;
 	reqbuf.is_write = 0;
 	reqbuf.is_multi_block = 0;
 	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
 
 	if (!_sd_storage_execute_app_cmd(storage, R1_STATE_TRAN, 0, &cmdbuf, &reqbuf, NULL))
 		return 0;
@@ -872,11 +1171,13 @@ int _sd_storage_switch_get(sdmmc_storage_t *storage, void *buf)
 
 	sdmmc_req_t reqbuf;
 	reqbuf.buf = buf;
+	reqbuf.sg_cnt = 0;
 	reqbuf.blksize = 64;
 	reqbuf.num_sectors = 1;
 	reqbuf.is_write = 0;
 	reqbuf.is_multi_block = 0;
 	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
 
 	if (!sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, NULL))
 		return 0;
@@ -896,11 +1197,13 @@ int _sd_storage_switch(sdmmc_storage_t *storage, void *buf, int mode, int group,
 
 	sdmmc_req_t reqbuf;
 	reqbuf.buf = buf;
+	reqbuf.sg_cnt = 0;
 	reqbuf.blksize = 64;
 	reqbuf.num_sectors = 1;
 	reqbuf.is_write = 0;
 	reqbuf.is_multi_block = 0;
 	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
 
 	if (!sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, NULL))
 		return 0;
@@ -1155,6 +1458,8 @@ static void _sd_storage_parse_ssr(sdmmc_storage_t *storage)
 
 	storage->ssr.au_size =     unstuff_bits(raw_ssr1, 428 - 384, 4);
 	storage->ssr.uhs_au_size = unstuff_bits(raw_ssr1, 392 - 384, 4);
+
+	storage->ssr.discard =     unstuff_bits(raw_ssr2, 313 - 256, 1);
 }
 
 int sd_storage_get_ssr(sdmmc_storage_t *storage, u8 *buf)
@@ -1164,11 +1469,13 @@ int sd_storage_get_ssr(sdmmc_storage_t *storage, u8 *buf)
 
 	sdmmc_req_t reqbuf;
 	reqbuf.buf = buf;
+	reqbuf.sg_cnt = 0;
 	reqbuf.blksize = 64;
 	reqbuf.num_sectors = 1;
 	reqbuf.is_write = 0;
 	reqbuf.is_multi_block = 0;
 	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
 
 	if (!(storage->csd.cmdclass & CCC_APP_SPEC))
 	{
@@ -1404,11 +1711,13 @@ int _gc_storage_custom_cmd(sdmmc_storage_t *storage, void *buf)
 
 	sdmmc_req_t reqbuf;
 	reqbuf.buf = buf;
+	reqbuf.sg_cnt = 0;
 	reqbuf.blksize = 64;
 	reqbuf.num_sectors = 1;
 	reqbuf.is_write = 1;
 	reqbuf.is_multi_block = 0;
 	reqbuf.is_auto_stop_trn = 0;
+	reqbuf.is_auto_set_blkcnt = 0;
 
 	if (!sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, NULL))
 	{
@@ -78,7 +78,10 @@ typedef struct _mmc_ext_csd
 	u8  rpmb_mult;
 	u16 dev_version;
 	u32 cache_size;
+	u8  cache_ctrl;   /* 33 */
+	u8  sec_feature;  /* 231 */
 	u32 max_enh_mult;
+	u8  max_packed_wr;
 } mmc_ext_csd_t;
 
 typedef struct _sd_scr
@@ -98,15 +101,28 @@ typedef struct _sd_ssr
 	u8  app_class;
 	u8  au_size;
 	u8  uhs_au_size;
+	u8  discard;
 	u32 protected_size;
 } sd_ssr_t;
 
+/*! eMMC packed write entry. */
+typedef struct _sdmmc_packed_wr_t
+{
+	u32 sector;
+	u32 num_sectors;
+	void *buf;
+} sdmmc_packed_wr_t;
+
+#define SDMMC_PACKED_WR_MAX_ENTRIES 63 // Limited by the 512B header.
+#define SDMMC_DISCARD_MAX_SECTORS   0x100000 // 512MB per erase command.
+
 /*! SDMMC storage context. */
 typedef struct _sdmmc_storage_t
 {
 	sdmmc_t *sdmmc;
 	u32 rca;
 	int has_sector_access;
+	int has_cmd23;
 	u32 sec_cnt;
 	int is_low_voltage;
 	u32 partition;
@@ -120,13 +136,23 @@ typedef struct _sdmmc_storage_t
 	mmc_ext_csd_t ext_csd;
 	sd_scr_t      scr;
 	sd_ssr_t      ssr;
+	u32 bounce_cnt;   // Requests that went through the bounce buffer.
+	u64 bounce_bytes;
 } sdmmc_storage_t;
 
 int  sdmmc_storage_end(sdmmc_storage_t *storage);
 int  sdmmc_storage_read(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf);
 int  sdmmc_storage_write(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf);
+int  sdmmc_storage_read_sg(sdmmc_storage_t *storage, u32 sector, sdmmc_sg_t *sg, u32 sg_cnt);
+int  sdmmc_storage_write_sg(sdmmc_storage_t *storage, u32 sector, sdmmc_sg_t *sg, u32 sg_cnt);
+int  sdmmc_storage_submit_rw(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 is_write);
+int  sdmmc_storage_wait_rw(sdmmc_storage_t *storage);
+int  sdmmc_storage_write_packed(sdmmc_storage_t *storage, sdmmc_packed_wr_t *wr, u32 wr_cnt);
+int  sdmmc_storage_discard(sdmmc_storage_t *storage, u32 sector, u32 num_sectors);
 int  sdmmc_storage_init_mmc(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type);
 int  sdmmc_storage_set_mmc_partition(sdmmc_storage_t *storage, u32 partition);
+int  sdmmc_storage_set_mmc_cache(sdmmc_storage_t *storage, u32 enable);
+int  sdmmc_storage_flush_mmc_cache(sdmmc_storage_t *storage);
 void sdmmc_storage_init_wait_sd();
 int  sdmmc_storage_init_sd(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type);
 int  sdmmc_storage_init_gc(sdmmc_storage_t *storage, sdmmc_t *sdmmc);
@@ -17,6 +17,7 @@
 
 #include <string.h>
 
+#include <memory_map.h>
 #include <storage/mmc.h>
 #include <storage/sdmmc.h>
 #include <gfx_utils.h>
@@ -740,7 +741,7 @@ static int _sdmmc_enable_internal_clock(sdmmc_t *sdmmc)
 		return 0;
 
 	sdmmc->regs->hostctl2 |= SDHCI_ADDRESSING_64BIT_EN;
-	sdmmc->regs->hostctl &= ~SDHCI_CTRL_DMA_MASK;
+	sdmmc->regs->hostctl = (sdmmc->regs->hostctl & ~SDHCI_CTRL_DMA_MASK) | SDHCI_CTRL_ADMA2;
 	sdmmc->regs->timeoutcon = (sdmmc->regs->timeoutcon & 0xF0) | 0xE;
 
 	return 1;
@@ -795,14 +796,14 @@ static int _sdmmc_autocal_config_offset(sdmmc_t *sdmmc, u32 power)
 static void _sdmmc_enable_interrupts(sdmmc_t *sdmmc)
 {
 	sdmmc->regs->norintstsen |= SDHCI_INT_DMA_END | SDHCI_INT_DATA_END | SDHCI_INT_RESPONSE;
-	sdmmc->regs->errintstsen |= SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR;
+	sdmmc->regs->errintstsen |= SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR | SDHCI_ERR_INT_ADMA_ERROR;
 	sdmmc->regs->norintsts = sdmmc->regs->norintsts;
 	sdmmc->regs->errintsts = sdmmc->regs->errintsts;
 }
 
 static void _sdmmc_mask_interrupts(sdmmc_t *sdmmc)
 {
-	sdmmc->regs->errintstsen &= ~SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR;
+	sdmmc->regs->errintstsen &= ~(SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR | SDHCI_ERR_INT_ADMA_ERROR);
 	sdmmc->regs->norintstsen &= ~(SDHCI_INT_DMA_END | SDHCI_INT_DATA_END | SDHCI_INT_RESPONSE);
 }
 
@@ -908,6 +909,105 @@ int sdmmc_stop_transmission(sdmmc_t *sdmmc, u32 *rsp)
 	return result;
 }
 
+static int _sdmmc_adma2_add_segment(sdmmc_adma2_desc_t **desc, u32 *desc_left, u32 addr, u32 size)
+{
+	// Check alignment.
+	if (addr & 7)
+		return 0;
+
+	while (size)
+	{
+		if (!*desc_left)
+			return 0;
+
+		u32 len = MIN(size, SDMMC_ADMA2_DESC_MAX_LEN);
+
+		(*desc)->attr = SDHCI_ADMA2_ACT_TRAN | SDHCI_ADMA2_VALID;
+		(*desc)->len = (u16)len;
+		(*desc)->addr = addr;
+		(*desc)->addr_hi = 0;
+		(*desc)->rsvd = 0;
+
+		(*desc)++;
+		(*desc_left)--;
+		addr += len;
+		size -= len;
+	}
+
+	return 1;
+}
+
+static int _sdmmc_adma2_build_table(sdmmc_t *sdmmc, sdmmc_req_t *req, u32 blkcnt)
+{
+	sdmmc_adma2_desc_t *table = (sdmmc_adma2_desc_t *)(SDMMC_ADMA_ADDR + sdmmc->id * SDMMC_ADMA2_DESC_CNT * sizeof(sdmmc_adma2_desc_t));
+	sdmmc_adma2_desc_t *desc = table;
+	u32 desc_left = SDMMC_ADMA2_DESC_CNT;
+	u32 size = blkcnt * req->blksize;
+
+	if (!req->sg_cnt)
+	{
+		if (!_sdmmc_adma2_add_segment(&desc, &desc_left, (u32)req->buf, size))
+			return 0;
+	}
+	else
+	{
+		sdmmc_sg_t *sg = (sdmmc_sg_t *)req->buf;
+		for (u32 i = 0; i < req->sg_cnt && size; i++)
+		{
+			u32 seg_size = MIN(sg[i].size, size);
+			if (!_sdmmc_adma2_add_segment(&desc, &desc_left, (u32)sg[i].buf, seg_size))
+				return 0;
+			size -= seg_size;
+		}
+
+		// Segments must cover the whole transfer.
+		if (size)
+			return 0;
+	}
+
+	(desc - 1)->attr |= SDHCI_ADMA2_END;
+
+	// Make descriptors visible to the controller.
+	bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_PHY, table, (u32)desc - (u32)table);
+
+	sdmmc->regs->admaaddr = (u32)table;
+	sdmmc->regs->admaaddr_hi = 0;
+
+	return 1;
+}
+
+static void _sdmmc_dma_cache_maintenance(sdmmc_req_t *req, u32 blkcnt, bool pre_xfer)
+{
+	// Nothing to do after a write.
+	if (!pre_xfer && req->is_write)
+		return;
+
+	// Writes only need their data cleaned. Reads must also drop any stale lines.
+	u32 op = req->is_write ? BPMP_MMU_MAINT_CLEAN_PHY : BPMP_MMU_MAINT_CLEAN_INVALID_PHY;
+	u32 size = blkcnt * req->blksize;
+
+	if (!req->sg_cnt)
+	{
+		bpmp_mmu_maintenance_range(op, req->buf, size);
+		return;
+	}
+
+	// Lists bigger than the range limit are faster with a single way based op.
+	if (size > BPMP_MMU_MAINT_RANGE_MAX)
+	{
+		bpmp_mmu_maintenance(op + (BPMP_MMU_MAINT_CLEAN_WAY - BPMP_MMU_MAINT_CLEAN_PHY), false);
+		return;
+	}
+
+	sdmmc_sg_t *sg = (sdmmc_sg_t *)req->buf;
+	for (u32 i = 0; i < req->sg_cnt && size; i++)
+	{
+		u32 seg_size = MIN(sg[i].size, size);
+		bpmp_mmu_maintenance_range(op, sg[i].buf, seg_size);
+		size -= seg_size;
+	}
+}
+
 static int _sdmmc_config_dma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
 {
 	if (!req->blksize || !req->num_sectors)
@@ -916,18 +1016,12 @@ static int _sdmmc_config_dma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
 	u32 blkcnt = req->num_sectors;
 	if (blkcnt >= 0xFFFF)
 		blkcnt = 0xFFFF;
-	u32 admaaddr = (u32)req->buf;
 
-	// Check alignment.
-	if (admaaddr & 7)
+	// Map the whole request in one descriptor table. No CPU intervention is needed until transfer end.
+	if (!_sdmmc_adma2_build_table(sdmmc, req, blkcnt))
 		return 0;
 
-	sdmmc->regs->admaaddr = admaaddr;
-	sdmmc->regs->admaaddr_hi = 0;
-
-	sdmmc->dma_addr_next = (admaaddr + 0x80000) & 0xFFF80000;
-
-	sdmmc->regs->blksize = req->blksize | 0x7000; // DMA 512KB (Detects A18 carry out).
+	sdmmc->regs->blksize = req->blksize;
 	sdmmc->regs->blkcnt = blkcnt;
 
 	if (blkcnt_out)
@@ -946,69 +1040,79 @@ static int _sdmmc_config_dma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
 	// Automatic send of stop transmission or set block count cmd.
 	if (req->is_auto_stop_trn)
 		trnmode |= SDHCI_TRNS_AUTO_CMD12;
-	//else if (req->is_auto_set_blkcnt)
-	//	trnmode |= SDHCI_TRNS_AUTO_CMD23;
+	else if (req->is_auto_set_blkcnt)
+	{
+		sdmmc->regs->sysad = blkcnt; // Argument 2. Used as CMD23 argument.
+		trnmode |= SDHCI_TRNS_AUTO_CMD23;
+	}
 
 	sdmmc->regs->trnmod = trnmode;
 
 	return 1;
 }
 
-static int _sdmmc_update_dma(sdmmc_t *sdmmc)
+// Returns 1 on transfer end, 0 on error and -1 if still in progress.
+static int _sdmmc_poll_dma(sdmmc_t *sdmmc)
 {
-	u16 blkcnt = 0;
-	do
+	u16 intr = 0;
+	int result = _sdmmc_check_mask_interrupt(sdmmc, &intr, SDHCI_INT_DATA_END);
+	if (result == SDMMC_MASKINT_MASKED)
+		return 1; // Transfer complete.
+
+	if (result != SDMMC_MASKINT_NOERROR)
 	{
-		blkcnt = sdmmc->regs->blkcnt;
-		u32 timeout = get_tmr_ms() + 1500;
-		do
-		{
-			int result = 0;
-			while (true)
-			{
-				u16 intr = 0;
-				result = _sdmmc_check_mask_interrupt(sdmmc, &intr,
-					SDHCI_INT_DATA_END | SDHCI_INT_DMA_END);
-				if (result < 0)
-					break;
-
-				if (intr & SDHCI_INT_DATA_END)
-					return 1; // Transfer complete.
-
-				if (intr & SDHCI_INT_DMA_END)
-				{
-					// Update DMA.
-					sdmmc->regs->admaaddr = sdmmc->dma_addr_next;
-					sdmmc->regs->admaaddr_hi = 0;
-					sdmmc->dma_addr_next += 0x80000;
-				}
-			}
-			if (result != SDMMC_MASKINT_NOERROR)
-			{
 #ifdef ERROR_EXTRA_PRINTING
-				EPRINTFARGS("%08X!", result);
+		EPRINTFARGS("%08X! ADMA: %02X", result, sdmmc->regs->admaerr);
 #endif
-				_sdmmc_reset(sdmmc);
-				return 0;
-			}
-		} while (get_tmr_ms() < timeout);
-	} while (sdmmc->regs->blkcnt != blkcnt);
+		_sdmmc_reset(sdmmc);
+		return 0;
+	}
 
-	_sdmmc_reset(sdmmc);
-	return 0;
+	// Restart timeout as long as blocks are being transferred.
+	u16 blkcnt = sdmmc->regs->blkcnt;
+	if (blkcnt != sdmmc->dma_blkcnt)
+	{
+		sdmmc->dma_blkcnt = blkcnt;
+		sdmmc->dma_timeout = get_tmr_ms() + 1500;
+	}
+	else if (get_tmr_ms() > sdmmc->dma_timeout)
+	{
+		_sdmmc_reset(sdmmc);
+		return 0;
+	}
+
+	return -1;
 }
 
-static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
+static void _sdmmc_start_dma_timeout(sdmmc_t *sdmmc)
+{
+	sdmmc->dma_blkcnt = sdmmc->regs->blkcnt;
+	sdmmc->dma_timeout = get_tmr_ms() + 1500;
+}
+
+static int _sdmmc_wait_dma(sdmmc_t *sdmmc)
+{
+	int result;
+
+	_sdmmc_start_dma_timeout(sdmmc);
+	do
+	{
+		result = _sdmmc_poll_dma(sdmmc);
+	} while (result < 0);
+
+	return result;
+}
+
+static int _sdmmc_execute_cmd_start(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt)
 {
 	int has_req_or_check_busy = req || cmd->check_busy;
 	if (!_sdmmc_wait_cmd_data_inhibit(sdmmc, has_req_or_check_busy))
 		return 0;
 
-	u32 blkcnt = 0;
 	bool is_data_present = false;
 	if (req)
 	{
-		if (!_sdmmc_config_dma(sdmmc, &blkcnt, req))
+		if (!_sdmmc_config_dma(sdmmc, blkcnt, req))
 		{
 #ifdef ERROR_EXTRA_PRINTING
 			EPRINTF("SDMMC: DMA Wrong cfg!");
@@ -1016,8 +1120,8 @@ static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_
 			return 0;
 		}
 
-		// Flush cache before starting the transfer.
-		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+		// Flush cache of the request buffers before starting the transfer.
+		_sdmmc_dma_cache_maintenance(req, *blkcnt, true);
 
 		is_data_present = true;
 	}
@@ -1041,39 +1145,31 @@ static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_
 	}
 DPRINTF("rsp(%d): %08X, %08X, %08X, %08X\n", result,
 		sdmmc->regs->rspreg0, sdmmc->regs->rspreg1, sdmmc->regs->rspreg2, sdmmc->regs->rspreg3);
-	if (result)
+	if (result && cmd->rsp_type)
 	{
-		if (cmd->rsp_type)
-		{
-			sdmmc->expected_rsp_type = cmd->rsp_type;
-			result = _sdmmc_cache_rsp(sdmmc, sdmmc->rsp, 0x10, cmd->rsp_type);
-			if (!result)
-			{
-#ifdef ERROR_EXTRA_PRINTING
-				EPRINTF("SDMMC: Unknown response type!");
-#endif
-			}
-		}
-		if (req && result)
+		sdmmc->expected_rsp_type = cmd->rsp_type;
+		result = _sdmmc_cache_rsp(sdmmc, sdmmc->rsp, 0x10, cmd->rsp_type);
+		if (!result)
 		{
-			result = _sdmmc_update_dma(sdmmc);
-			if (!result)
-			{
 #ifdef ERROR_EXTRA_PRINTING
-				EPRINTF("SDMMC: DMA Update failed!");
+			EPRINTF("SDMMC: Unknown response type!");
 #endif
-			}
 		}
 	}
 
+	return result;
+}
+
+static int _sdmmc_execute_cmd_finish(sdmmc_t *sdmmc, sdmmc_req_t *req, u32 check_busy, u32 blkcnt, u32 *blkcnt_out, int result)
+{
 	_sdmmc_mask_interrupts(sdmmc);
 
 	if (result)
 	{
 		if (req)
 		{
-			// Flush cache after transfer.
-			bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+			// Invalidate cache of the request buffers after transfer.
+			_sdmmc_dma_cache_maintenance(req, blkcnt, false);
 
 			if (blkcnt_out)
 				*blkcnt_out = blkcnt;
@@ -1082,7 +1178,7 @@ DPRINTF("rsp(%d): %08X, %08X, %08X, %08X\n", result,
 				sdmmc->rsp3 = sdmmc->regs->rspreg3;
 		}
 
-		if (cmd->check_busy || req)
+		if (check_busy || req)
 		{
 			result = _sdmmc_wait_card_busy(sdmmc);
 			if (!result)
@@ -1098,6 +1194,25 @@ DPRINTF("rsp(%d): %08X, %08X, %08X, %08X\n", result,
 	return result;
 }
 
+static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
+{
+	u32 blkcnt = 0;
+	int result = _sdmmc_execute_cmd_start(sdmmc, cmd, req, &blkcnt);
+
+	if (req && result)
+	{
+		result = _sdmmc_wait_dma(sdmmc);
+		if (!result)
+		{
+#ifdef ERROR_EXTRA_PRINTING
+			EPRINTF("SDMMC: DMA transfer failed!");
+#endif
+		}
+	}
+
+	return _sdmmc_execute_cmd_finish(sdmmc, req, cmd->check_busy, blkcnt, blkcnt_out, result);
+}
+
 bool sdmmc_get_sd_inserted()
 {
 	return (!gpio_read(GPIO_PORT_Z, GPIO_PIN_1));
@@ -1398,29 +1513,116 @@ void sdmmc_init_cmd(sdmmc_cmd_t *cmdbuf, u16 cmd, u32 arg, u32 rsp_type, u32 che
 	cmdbuf->check_busy = check_busy;
 }
 
-int sdmmc_execute_cmd(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
+static int _sdmmc_execute_cmd_prepare(sdmmc_t *sdmmc, int *should_disable_sd_clock)
 {
 	if (!sdmmc->card_clock_enabled)
 		return 0;
 
+	// Controller is busy with an asynchronous request.
+	if (sdmmc->async_state == SDMMC_ASYNC_BUSY)
+		return 0;
+
 	// Recalibrate periodically for SDMMC1.
 	if (sdmmc->manual_cal && sdmmc->powersave_enabled)
 		_sdmmc_autocal_execute(sdmmc, sdmmc_get_io_power(sdmmc));
 
-	int should_disable_sd_clock = 0;
+	*should_disable_sd_clock = 0;
 	if (!(sdmmc->regs->clkcon & SDHCI_CLOCK_CARD_EN))
 	{
-		should_disable_sd_clock = 1;
+		*should_disable_sd_clock = 1;
 		sdmmc->regs->clkcon |= SDHCI_CLOCK_CARD_EN;
 		_sdmmc_commit_changes(sdmmc);
 		usleep((8000 + sdmmc->divisor - 1) / sdmmc->divisor);
 	}
 
-	int result = _sdmmc_execute_cmd_inner(sdmmc, cmd, req, blkcnt_out);
+	return 1;
+}
+
+static void _sdmmc_execute_cmd_end(sdmmc_t *sdmmc, int should_disable_sd_clock)
+{
 	usleep((8000 + sdmmc->divisor - 1) / sdmmc->divisor);
 
 	if (should_disable_sd_clock)
 		sdmmc->regs->clkcon &= ~SDHCI_CLOCK_CARD_EN;
+}
+
+int sdmmc_execute_cmd(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
+{
+	int should_disable_sd_clock;
+	if (!_sdmmc_execute_cmd_prepare(sdmmc, &should_disable_sd_clock))
+		return 0;
+
+	int result = _sdmmc_execute_cmd_inner(sdmmc, cmd, req, blkcnt_out);
+
+	_sdmmc_execute_cmd_end(sdmmc, should_disable_sd_clock);
+
+	return result;
+}
+
+/*
+ * Asynchronous data requests.
+ * sdmmc_submit_rw() returns as soon as the command is accepted by the card and the ADMA2 transfer
+ * is running. Completion is then driven by sdmmc_poll(), so multiple controllers can be serviced
+ * from a single loop. The request is copied, but its buffers (or sg list) must stay valid until
+ * sdmmc_wait() returns.
+ */
+int sdmmc_submit_rw(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req)
+{
+	if (!req)
+		return 0;
+
+	if (!_sdmmc_execute_cmd_prepare(sdmmc, &sdmmc->async_disable_sd_clock))
+		return 0;
+
+	memcpy(&sdmmc->async_req, req, sizeof(sdmmc_req_t));
+	sdmmc->async_blkcnt = 0;
+
+	if (!_sdmmc_execute_cmd_start(sdmmc, cmd, &sdmmc->async_req, &sdmmc->async_blkcnt))
+	{
+		_sdmmc_execute_cmd_finish(sdmmc, &sdmmc->async_req, cmd->check_busy, 0, NULL, 0);
+		_sdmmc_execute_cmd_end(sdmmc, sdmmc->async_disable_sd_clock);
+
+		return 0;
+	}
+
+	_sdmmc_start_dma_timeout(sdmmc);
+	sdmmc->async_state = SDMMC_ASYNC_BUSY;
+
+	return 1;
+}
+
+int sdmmc_poll(sdmmc_t *sdmmc)
+{
+	if (sdmmc->async_state != SDMMC_ASYNC_BUSY)
+		return sdmmc->async_state;
+
+	int result = _sdmmc_poll_dma(sdmmc);
+	if (result < 0)
+		return SDMMC_ASYNC_BUSY;
+
+#ifdef ERROR_EXTRA_PRINTING
+	if (!result)
+		EPRINTF("SDMMC: DMA transfer failed!");
+#endif
+
+	result = _sdmmc_execute_cmd_finish(sdmmc, &sdmmc->async_req, 0, sdmmc->async_blkcnt, NULL, result);
+	_sdmmc_execute_cmd_end(sdmmc, sdmmc->async_disable_sd_clock);
+
+	sdmmc->async_state = result ? SDMMC_ASYNC_DONE : SDMMC_ASYNC_ERROR;
+
+	return sdmmc->async_state;
+}
+
+int sdmmc_wait(sdmmc_t *sdmmc, u32 *blkcnt_out)
+{
+	while (sdmmc_poll(sdmmc) == SDMMC_ASYNC_BUSY)
+		;
+
+	int result = sdmmc->async_state == SDMMC_ASYNC_DONE;
+	if (result && blkcnt_out)
+		*blkcnt_out = sdmmc->async_blkcnt;
+
+	sdmmc->async_state = SDMMC_ASYNC_IDLE;
 
 	return result;
 }
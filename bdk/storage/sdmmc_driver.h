@@ -94,6 +94,7 @@
 #define  SDHCI_CTRL_SDMA      0x00
 #define  SDHCI_CTRL_ADMA1     0x08
 #define  SDHCI_CTRL_ADMA32    0x10
+#define  SDHCI_CTRL_ADMA2     0x10 // 64-bit descriptors when Host Version 4 and 64-bit addressing are enabled.
 #define  SDHCI_CTRL_ADMA64    0x18
 #define  SDHCI_CTRL_8BITBUS   0x20
 #define SDHCI_CTRL_CDTEST_INS 0x40
@@ -199,6 +200,17 @@
 
 #define SDHCI_CAN_64BIT 0x10000000
 
+/*! SDMMC ADMA2 descriptor attributes. */
+#define SDHCI_ADMA2_VALID    0x1
+#define SDHCI_ADMA2_END      0x2
+#define SDHCI_ADMA2_INT      0x4
+#define SDHCI_ADMA2_ACT_NOP  0x0
+#define SDHCI_ADMA2_ACT_TRAN 0x20
+#define SDHCI_ADMA2_ACT_LINK 0x30
+
+#define SDMMC_ADMA2_DESC_MAX_LEN 0xFE00  // 127 sectors. T210 can't do zero length (64KB) descriptors.
+#define SDMMC_ADMA2_DESC_CNT     1024    // Per controller. 16KB table.
+
 /*! SDMMC Low power features. */
 #define SDMMC_POWER_SAVE_DISABLE 0
 #define SDMMC_POWER_SAVE_ENABLE  1
@@ -206,6 +218,42 @@
 /*! Helper for SWITCH command argument. */
 #define SDMMC_SWITCH(mode, index, value) (((mode) << 24) | ((index) << 16) | ((value) << 8))
 
+/*! SDMMC ADMA2 64-bit descriptor (Host Version 4 128-bit layout). */
+typedef struct _sdmmc_adma2_desc_t
+{
+	u16 attr;
+	u16 len;
+	u32 addr;
+	u32 addr_hi;
+	u32 rsvd;
+} sdmmc_adma2_desc_t;
+
+/*! SDMMC scatter-gather segment. Buffer must be 8-byte aligned and reside in DRAM. */
+typedef struct _sdmmc_sg_t
+{
+	void *buf;
+	u32 size;
+} sdmmc_sg_t;
+
+/*! SDMMC request. */
+typedef struct _sdmmc_req_t
+{
+	void *buf;    // If sg_cnt is set, it points to an sdmmc_sg_t list.
+	u32 sg_cnt;
+	u32 blksize;
+	u32 num_sectors;
+	int is_write;
+	int is_multi_block;
+	int is_auto_stop_trn;
+	int is_auto_set_blkcnt;
+} sdmmc_req_t;
+
+/*! SDMMC asynchronous request state. */
+#define SDMMC_ASYNC_IDLE  0
+#define SDMMC_ASYNC_BUSY  1
+#define SDMMC_ASYNC_DONE  2
+#define SDMMC_ASYNC_ERROR 3
+
 /*! SDMMC controller context. */
 typedef struct _sdmmc_t
 {
@@ -219,7 +267,12 @@ typedef struct _sdmmc_t
 	int venclkctl_set;
 	u32 venclkctl_tap;
 	u32 expected_rsp_type;
-	u32 dma_addr_next;
+	u32 dma_timeout;
+	u16 dma_blkcnt;
+	u32 async_state;
+	u32 async_blkcnt;
+	int async_disable_sd_clock;
+	sdmmc_req_t async_req;
 	u32 rsp[4];
 	u32 rsp3;
 	int t210b01;
@@ -234,17 +287,6 @@ typedef struct _sdmmc_cmd_t
 	u32 check_busy;
 } sdmmc_cmd_t;
 
-/*! SDMMC request. */
-typedef struct _sdmmc_req_t
-{
-	void *buf;
-	u32 blksize;
-	u32 num_sectors;
-	int is_write;
-	int is_multi_block;
-	int is_auto_stop_trn;
-} sdmmc_req_t;
-
 int  sdmmc_get_io_power(sdmmc_t *sdmmc);
 u32  sdmmc_get_bus_width(sdmmc_t *sdmmc);
 void sdmmc_set_bus_width(sdmmc_t *sdmmc, u32 bus_width);
@@ -259,6 +301,9 @@ int  sdmmc_init(sdmmc_t *sdmmc, u32 id, u32 power, u32 bus_width, u32 type, int
 void sdmmc_end(sdmmc_t *sdmmc);
 void sdmmc_init_cmd(sdmmc_cmd_t *cmdbuf, u16 cmd, u32 arg, u32 rsp_type, u32 check_busy);
 int  sdmmc_execute_cmd(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out);
+int  sdmmc_submit_rw(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req);
+int  sdmmc_poll(sdmmc_t *sdmmc);
+int  sdmmc_wait(sdmmc_t *sdmmc, u32 *blkcnt_out);
 int  sdmmc_enable_low_voltage(sdmmc_t *sdmmc);
 
 #endif
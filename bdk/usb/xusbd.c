@@ -993,7 +993,11 @@ static int _xusb_queue_trb(int ep_idx, void *trb, bool ring_doorbell)
 	// Ring doorbell.
 	if (ring_doorbell)
 	{
-		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+		// Flush rings, EP contexts and the TRB data buffer.
+		normal_trb_t *queued_trb = (normal_trb_t *)trb;
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, xusb_evtq, sizeof(xusbd_event_queues_t));
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY,
+			(void *)queued_trb->databufptr_lo, queued_trb->trb_tx_len);
 		u32 target_id = (ep_idx << 8) & 0xFFFF;
 		if (ep_idx == XUSB_EP_CTRL_IN)
 			target_id |= usbd_xotg->ctrl_seq_num << 16;
@@ -1867,7 +1871,7 @@ int xusb_device_ep1_out_read(u8 *buf, u32 len, u32 *bytes_read, u32 sync_tries)
 		if (bytes_read)
 			*bytes_read = res ? 0 : usbd_xotg->bytes_remaining[USB_DIR_OUT];
 
-		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+		bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, buf, len);
 	}
 
 	return res;
@@ -1917,8 +1921,6 @@ int xusb_device_ep1_in_write(u8 *buf, u32 len, u32 *bytes_written, u32 sync_trie
 	if (len > USB_EP_BUFFER_MAX_SIZE)
 		len = USB_EP_BUFFER_MAX_SIZE;
 
-	bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
-
 	int res = USB_RES_OK;
 	usbd_xotg->tx_count[USB_DIR_IN] = 0;
 	usbd_xotg->bytes_remaining[USB_DIR_IN] = len;
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "btrace.h"
+#include <utils/util.h>
+
+static btrace_t *btrace = NULL;
+
+static void _btrace_add(u32 id)
+{
+	if (!btrace)
+		return;
+
+	btrace_entry_t *entry = &btrace->entry[btrace->idx % BTRACE_ENTRIES];
+	entry->id = id;
+	entry->rsvd = 0;
+	entry->ts_us = get_tmr_us();
+	btrace->idx++;
+}
+
+void btrace_init(btrace_t *bt)
+{
+	btrace = bt;
+	btrace->magic = BTRACE_MAGIC;
+	btrace->idx = 0;
+
+	// Time until DRAM is usable is counted from timer reset.
+	_btrace_add(BT_HW_INIT);
+	btrace->entry[0].ts_us = 0;
+	_btrace_add(BT_HW_INIT | BTRACE_END);
+}
+
+btrace_t *btrace_get()
+{
+	return btrace;
+}
+
+void btrace_begin(u32 id)
+{
+	_btrace_add(id);
+}
+
+void btrace_end(u32 id)
+{
+	_btrace_add(id | BTRACE_END);
+}
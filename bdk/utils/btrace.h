@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BTRACE_H_
+#define _BTRACE_H_
+
+#include <utils/types.h>
+
+#define BTRACE_MAGIC   0x43525442 // "BTRC".
+#define BTRACE_ENTRIES 64
+
+#define BTRACE_END BIT(15)
+
+// Boot phase IDs. Append only, Nyx and saved traces depend on these.
+enum
+{
+	BT_HW_INIT      = 0,
+	BT_SD_MOUNT     = 1,
+	BT_MTC_INIT     = 2,
+	BT_DISPLAY_INIT = 3,
+	BT_AUTOBOOT     = 4,
+	BT_INI_PARSE    = 5,
+	BT_NYX_LOAD     = 6,
+	BT_HOS_LAUNCH   = 7,
+	BT_EMMC_INIT    = 8,
+	BT_PKG1_READ    = 9,
+	BT_BOOT_CFG     = 10,
+	BT_FSS_PARSE    = 11,
+	BT_KEYGEN       = 12,
+	BT_PKG1_UNPACK  = 13,
+	BT_PKG2_READ    = 14,
+	BT_PKG2_DECRYPT = 15,
+	BT_KIP_PARSE    = 16,
+	BT_KIP_PATCH    = 17,
+	BT_PKG2_BUILD   = 18,
+	BT_CFG_CACHE    = 19,
+	BT_PHASE_MAX
+};
+
+typedef struct _btrace_entry_t
+{
+	u16 id;    // Phase ID. BTRACE_END set on phase end.
+	u16 rsvd;
+	u32 ts_us; // get_tmr_us() stamp.
+} btrace_entry_t;
+
+typedef struct _btrace_t
+{
+	u32 magic;
+	u32 idx; // Total entries recorded. Ring wraps at BTRACE_ENTRIES.
+	btrace_entry_t entry[BTRACE_ENTRIES];
+} btrace_t;
+
+void btrace_init(btrace_t *bt);
+btrace_t *btrace_get();
+void btrace_begin(u32 id);
+void btrace_end(u32 id);
+
+#endif
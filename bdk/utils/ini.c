@@ -21,6 +21,7 @@
 #include <libs/fatfs/ff.h>
 #include <mem/heap.h>
 #include <utils/dirlist.h>
+#include <utils/util.h>
 
 static char *_strdup(char *str)
 {
@@ -64,9 +65,450 @@ ini_sec_t *_ini_create_section(link_t *dst, ini_sec_t *csec, char *name, u8 type
 	return csec;
 }
 
-int ini_parse(link_t *dst, char *ini_path, bool is_dir)
+#define INI_ARENA_MAGIC   0x4E524149 // "IARN".
+#define INI_ARENA_FILES   32
+#define INI_ARENA_PATH_SZ 64
+#define INI_ARENA_BUCKETS 256
+#define INI_ARENA_KV_MAX  2048
+#define INI_ARENA_SEC     0xFFFFFFFF // Key of section markers.
+
+enum
+{
+	INI_ARENA_FREE    = 0,
+	INI_ARENA_LOADED  = 1,
+	INI_ARENA_MISSING = 2
+};
+
+typedef struct _ini_arena_file_t
+{
+	char path[INI_ARENA_PATH_SZ];
+	u32  state;
+	u32  off;  // Raw file offset in data.
+	u32  size;
+	u32  crc;
+} ini_arena_file_t;
+
+typedef struct _ini_arena_kv_t
+{
+	u32 hash;
+	u16 file;
+	u16 next; // Next entry in bucket + 1. 0: End.
+	u32 sec;  // String offsets in data.
+	u32 key;
+	u32 val;
+} ini_arena_kv_t;
+
+typedef struct _ini_arena_t
+{
+	u32 magic;
+	u32 size;   // Including header.
+	u32 used;   // Data bytes used.
+	u32 kv_cnt;
+	ini_arena_file_t file[INI_ARENA_FILES];
+	u16 bucket[INI_ARENA_BUCKETS];
+	ini_arena_kv_t kv[INI_ARENA_KV_MAX];
+	char data[];
+} ini_arena_t;
+
+static ini_arena_t *_arena = NULL;
+
+void ini_arena_init(void *base, u32 size, bool keep)
+{
+	_arena = (ini_arena_t *)base;
+
+	// Keep the previous boot stage's arena if valid.
+	if (keep && _arena->magic == INI_ARENA_MAGIC && _arena->size == size)
+		return;
+
+	memset(_arena, 0, sizeof(ini_arena_t));
+	_arena->magic = INI_ARENA_MAGIC;
+	_arena->size = size;
+}
+
+static u32 _ini_arena_hash(const char *sec, const char *key)
 {
+	// FNV-1a.
+	u32 hash = 0x811C9DC5;
+	for (; *sec; sec++)
+		hash = (hash ^ (u8)*sec) * 0x01000193;
+
+	hash = (hash ^ 0xFF) * 0x01000193;
+
+	if (key)
+		for (; *key; key++)
+			hash = (hash ^ (u8)*key) * 0x01000193;
+
+	return hash;
+}
+
+static ini_arena_kv_t *_ini_arena_find(u32 file, const char *sec, const char *key, u32 hash)
+{
+	u32 idx = _arena->bucket[hash % INI_ARENA_BUCKETS];
+	while (idx)
+	{
+		ini_arena_kv_t *kv = &_arena->kv[idx - 1];
+		if (kv->hash == hash && kv->file == file && !strcmp(_arena->data + kv->sec, sec))
+		{
+			if (!key && kv->key == INI_ARENA_SEC)
+				return kv;
+			if (key && kv->key != INI_ARENA_SEC && !strcmp(_arena->data + kv->key, key))
+				return kv;
+		}
+		idx = kv->next;
+	}
+
+	return NULL;
+}
+
+static bool _ini_arena_add(u32 file, u32 sec, u32 key, u32 val)
+{
+	if (_arena->kv_cnt >= INI_ARENA_KV_MAX)
+		return false;
+
+	const char *key_str = key != INI_ARENA_SEC ? _arena->data + key : NULL;
+	u32 hash = _ini_arena_hash(_arena->data + sec, key_str);
+
+	// Same key again in a section. Last one wins, as in a list walk.
+	ini_arena_kv_t *kv = _ini_arena_find(file, _arena->data + sec, key_str, hash);
+	if (kv)
+	{
+		kv->val = val;
+		return true;
+	}
+
+	kv = &_arena->kv[_arena->kv_cnt];
+	kv->hash = hash;
+	kv->file = file;
+	kv->sec = sec;
+	kv->key = key;
+	kv->val = val;
+	kv->next = _arena->bucket[hash % INI_ARENA_BUCKETS];
+
+	_arena->kv_cnt++;
+	_arena->bucket[hash % INI_ARENA_BUCKETS] = _arena->kv_cnt;
+
+	return true;
+}
+
+static void _ini_arena_unlink(u32 file)
+{
+	for (u32 i = 0; i < INI_ARENA_BUCKETS; i++)
+	{
+		u16 *link = &_arena->bucket[i];
+		while (*link)
+		{
+			ini_arena_kv_t *kv = &_arena->kv[*link - 1];
+			if (kv->file == file)
+				*link = kv->next;
+			else
+				link = &kv->next;
+		}
+	}
+}
+
+static u32 _ini_arena_str(const char *str)
+{
+	// Trim like _strdup.
+	if (str[0] == ' ' && strlen(str))
+		str++;
+
+	u32 len = strlen(str);
+	if (len && str[len - 1] == ' ')
+		len--;
+
+	if (_arena->used + len + 1 > _arena->size - sizeof(ini_arena_t))
+		return INI_ARENA_SEC;
+
+	u32 off = _arena->used;
+	memcpy(_arena->data + off, str, len);
+	_arena->data[off + len] = 0;
+	_arena->used += len + 1;
+
+	return off;
+}
+
+static bool _ini_arena_index(u32 file)
+{
+	ini_arena_file_t *af = &_arena->file[file];
+	ini_file_t ifp;
+	u32 lblen;
+	u32 sec = INI_ARENA_SEC; // Section whose keys get indexed.
+	bool res = false;
+
+	ifp.arena = true;
+	ifp.ptr = _arena->data + af->off;
+	ifp.end = ifp.ptr + af->size;
+
+	char *lbuf = malloc(512);
+
+	// Same line rules as ini_parse.
+	do
+	{
+		lbuf[0] = 0;
+		ini_file_gets(lbuf, 512, &ifp);
+		lblen = strlen(lbuf);
+
+		if (lblen && lbuf[lblen - 1] == '\n')
+			lbuf[lblen - 1] = 0;
+
+		if (lblen > 2 && lbuf[0] == '[')
+		{
+			_find_section_name(lbuf, lblen, ']');
+
+			sec = _ini_arena_str(&lbuf[1]);
+			if (sec == INI_ARENA_SEC)
+				goto out;
+
+			// Lookups stop at the first section with that name.
+			if (_ini_arena_find(file, _arena->data + sec, NULL, _ini_arena_hash(_arena->data + sec, NULL)))
+				sec = INI_ARENA_SEC;
+			else if (!_ini_arena_add(file, sec, INI_ARENA_SEC, INI_ARENA_SEC))
+				goto out;
+		}
+		else if ((lblen > 1 && lbuf[0] == '{') || (lblen > 2 && lbuf[0] == '#') || lblen < 2)
+			sec = INI_ARENA_SEC;
+		else if (sec != INI_ARENA_SEC)
+		{
+			bool has_val = strchr(lbuf, '=') != NULL;
+			u32 i = _find_section_name(lbuf, lblen, '=');
+
+			u32 key = _ini_arena_str(lbuf);
+			u32 val = _ini_arena_str(has_val ? &lbuf[i + 1] : "");
+			if (key == INI_ARENA_SEC || val == INI_ARENA_SEC || !_ini_arena_add(file, sec, key, val))
+				goto out;
+		}
+	} while (!ini_file_eof(&ifp));
+
+	res = true;
+
+out:
+	free(lbuf);
+
+	return res;
+}
+
+static int _ini_arena_load(const char *path)
+{
+	int file = -1;
 	FIL fp;
+	UINT br;
+
+	if (!_arena || strlen(path) >= INI_ARENA_PATH_SZ)
+		return -1;
+
+	for (u32 i = 0; i < INI_ARENA_FILES; i++)
+	{
+		if (_arena->file[i].state == INI_ARENA_FREE)
+		{
+			if (file < 0)
+				file = i;
+		}
+		else if (!strcmp(_arena->file[i].path, path))
+			return i;
+	}
+
+	if (file < 0)
+		return -1;
+
+	ini_arena_file_t *af = &_arena->file[file];
+
+	// Missing files are remembered too.
+	int res = f_open(&fp, path, FA_READ);
+	if (res == FR_NO_FILE || res == FR_NO_PATH)
+	{
+		strcpy(af->path, path);
+		af->state = INI_ARENA_MISSING;
+
+		return file;
+	}
+	else if (res)
+		return -1;
+
+	u32 used = _arena->used;
+	u32 kv_cnt = _arena->kv_cnt;
+
+	af->off = used;
+	af->size = f_size(&fp);
+	if (af->size >= _arena->size - sizeof(ini_arena_t) - used ||
+		f_read(&fp, _arena->data + used, af->size, &br) || br != af->size)
+	{
+		f_close(&fp);
+		return -1;
+	}
+	f_close(&fp);
+
+	af->crc = crc32_calc(0, (u8 *)_arena->data + used, af->size);
+	_arena->used += af->size;
+
+	// Index it. If it doesn't fit, roll back and let the caller read it from SD.
+	if (!_ini_arena_index(file))
+	{
+		_ini_arena_unlink(file);
+		_arena->used = used;
+		_arena->kv_cnt = kv_cnt;
+
+		return -1;
+	}
+
+	strcpy(af->path, path);
+	af->state = INI_ARENA_LOADED;
+
+	return file;
+}
+
+void ini_arena_drop(const char *path)
+{
+	if (!_arena)
+		return;
+
+	// Data is not reclaimed, so strings handed out stay valid.
+	for (u32 i = 0; i < INI_ARENA_FILES; i++)
+	{
+		if (_arena->file[i].state != INI_ARENA_FREE && (!path || !strcmp(_arena->file[i].path, path)))
+		{
+			_ini_arena_unlink(i);
+			_arena->file[i].state = INI_ARENA_FREE;
+		}
+	}
+}
+
+bool ini_arena_stamp(const char *path, u32 *size, u32 *crc)
+{
+	int file = _ini_arena_load(path);
+	if (file < 0 || _arena->file[file].state != INI_ARENA_LOADED)
+		return false;
+
+	*size = _arena->file[file].size;
+	*crc = _arena->file[file].crc;
+
+	return true;
+}
+
+static void _ini_free_sections(link_t *src)
+{
+	LIST_FOREACH_SAFE(iter, src)
+	{
+		ini_sec_t *ini_sec = CONTAINER_OF(iter, ini_sec_t, link);
+
+		// Only choice sections have a key list.
+		if (ini_sec->type == INI_CHOICE)
+		{
+			LIST_FOREACH_SAFE(kv_iter, &ini_sec->kvs)
+			{
+				ini_kv_t *kv = CONTAINER_OF(kv_iter, ini_kv_t, link);
+				free(kv->key);
+				free(kv->val);
+				free(kv);
+			}
+		}
+
+		free(ini_sec->name);
+		free(ini_sec);
+	}
+
+	list_init(src);
+}
+
+char *ini_arena_get(const char *path, const char *sec, const char *key)
+{
+	int file = _ini_arena_load(path);
+	if (file < 0)
+	{
+		// Not cacheable. Parse it from SD and keep only a copy of the value.
+		char *val = NULL;
+		LIST_INIT(ini_sections);
+		if (ini_parse(&ini_sections, (char *)path, false))
+		{
+			LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_sections, link)
+			{
+				if (ini_sec->type != INI_CHOICE || strcmp(ini_sec->name, sec))
+					continue;
+
+				LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
+					if (!strcmp(kv->key, key))
+						val = kv->val;
+
+				if (val)
+				{
+					char *res = (char *)malloc(strlen(val) + 1);
+					strcpy(res, val);
+					val = res;
+				}
+				break;
+			}
+		}
+
+		_ini_free_sections(&ini_sections);
+
+		return val;
+	}
+
+	if (_arena->file[file].state != INI_ARENA_LOADED)
+		return NULL;
+
+	ini_arena_kv_t *kv = _ini_arena_find(file, sec, key, _ini_arena_hash(sec, key));
+
+	return kv ? _arena->data + kv->val : NULL;
+}
+
+int ini_file_open(ini_file_t *ifp, const char *path)
+{
+	int file = _ini_arena_load(path);
+	if (file < 0)
+	{
+		ifp->arena = false;
+
+		return f_open(&ifp->fp, path, FA_READ);
+	}
+
+	if (_arena->file[file].state != INI_ARENA_LOADED)
+		return FR_NO_FILE;
+
+	ifp->arena = true;
+	ifp->ptr = _arena->data + _arena->file[file].off;
+	ifp->end = ifp->ptr + _arena->file[file].size;
+
+	return FR_OK;
+}
+
+char *ini_file_gets(char *buf, u32 len, ini_file_t *ifp)
+{
+	if (!ifp->arena)
+		return f_gets(buf, len, &ifp->fp);
+
+	// Same as f_gets with 'FF_USE_STRFUNC 2'.
+	u32 nc = 0;
+	char *p = buf;
+	while (nc < len - 1 && ifp->ptr < ifp->end)
+	{
+		char ch = *ifp->ptr++;
+		if (ch == '\r')
+			continue;
+
+		*p++ = ch;
+		nc++;
+		if (ch == '\n')
+			break;
+	}
+	*p = 0;
+
+	return nc ? buf : NULL;
+}
+
+bool ini_file_eof(ini_file_t *ifp)
+{
+	return ifp->arena ? ifp->ptr >= ifp->end : f_eof(&ifp->fp);
+}
+
+void ini_file_close(ini_file_t *ifp)
+{
+	if (!ifp->arena)
+		f_close(&ifp->fp);
+}
+
+int ini_parse(link_t *dst, char *ini_path, bool is_dir)
+{
+	ini_file_t fp;
 	u32 lblen;
 	u32 pathlen = strlen(ini_path);
 	u32 k = 0;
@@ -106,7 +548,7 @@ int ini_parse(link_t *dst, char *ini_path, bool is_dir)
 		}
 
 		// Open ini.
-		if (f_open(&fp, filename, FA_READ) != FR_OK)
+		if (ini_file_open(&fp, filename) != FR_OK)
 		{
 			free(filelist);
 			free(filename);
@@ -120,7 +562,7 @@ int ini_parse(link_t *dst, char *ini_path, bool is_dir)
 		{
 			// Fetch one line.
 			lbuf[0] = 0;
-			f_gets(lbuf, 512, &fp);
+			ini_file_gets(lbuf, 512, &fp);
 			lblen = strlen(lbuf);
 
 			// Remove trailing newline. Depends on 'FF_USE_STRFUNC 2' that removes \r.
@@ -158,9 +600,9 @@ int ini_parse(link_t *dst, char *ini_path, bool is_dir)
 				kv->val = _strdup(&lbuf[i + 1]);
 				list_append(&csec->kvs, &kv->link);
 			}
-		} while (!f_eof(&fp));
+		} while (!ini_file_eof(&fp));
 
-		f_close(&fp);
+		ini_file_close(&fp);
 
 		if (csec)
 		{
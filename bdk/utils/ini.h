@@ -18,6 +18,7 @@
 #ifndef _INI_H_
 #define _INI_H_
 
+#include <libs/fatfs/ff.h>
 #include <utils/types.h>
 #include <utils/list.h>
 
@@ -43,6 +44,24 @@ typedef struct _ini_sec_t
 	u32 color;
 } ini_sec_t;
 
+typedef struct _ini_file_t
+{
+	FIL fp;
+	bool arena;      // Served from the config arena.
+	const char *ptr;
+	const char *end;
+} ini_file_t;
+
+void  ini_arena_init(void *base, u32 size, bool keep);
+void  ini_arena_drop(const char *path);
+bool  ini_arena_stamp(const char *path, u32 *size, u32 *crc);
+char *ini_arena_get(const char *path, const char *sec, const char *key);
+
+int   ini_file_open(ini_file_t *ifp, const char *path);
+char *ini_file_gets(char *buf, u32 len, ini_file_t *ifp);
+bool  ini_file_eof(ini_file_t *ifp);
+void  ini_file_close(ini_file_t *ifp);
+
 int ini_parse(link_t *dst, char *ini_path, bool is_dir);
 char *ini_check_payload_section(ini_sec_t *cfg);
 
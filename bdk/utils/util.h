@@ -20,6 +20,7 @@
 
 #include <utils/types.h>
 #include <mem/minerva.h>
+#include <utils/btrace.h>
 
 #define NYX_NEW_INFO 0x3058594E
 
@@ -67,18 +68,22 @@ typedef struct _nyx_info_t
 	u32 magic;
 	u32 sd_init;
 	u32 sd_errors[3];
-	u8  rsvd[0x1000];
+	btrace_t btrace;
+	u8  rsvd[0x1000 - sizeof(btrace_t)];
 	u32 disp_id;
 	u32 errors;
 } nyx_info_t;
 
+#define NYX_INI_ARENA_SZ 0x40000
+
 typedef struct _nyx_storage_t
 {
 	u32 version;
 	u32 cfg;
 	u8  irama[0x8000];
 	u8  hekate[0x30000];
-	u8  rsvd[0x800000 - sizeof(nyx_info_t)];
+	u8  ini_arena[NYX_INI_ARENA_SZ]; // Config files shared by hekate and Nyx.
+	u8  rsvd[0x800000 - sizeof(nyx_info_t) - NYX_INI_ARENA_SZ];
 	nyx_info_t info;
 	mtc_config_t mtc_cfg;
 	emc_table_t mtc_table[10];
@@ -19,9 +19,11 @@
 
 #include "config.h"
 #include <utils/ini.h>
+#include <display/di.h>
 #include <gfx_utils.h>
 #include "gfx/tui.h"
 #include <libs/fatfs/ff.h>
+#include <mem/heap.h>
 #include <soc/fuse.h>
 #include <soc/hw_init.h>
 #include <soc/t210.h>
@@ -32,6 +34,8 @@
 #include <utils/util.h>
 
 extern hekate_config h_cfg;
+extern const volatile ipl_ver_meta_t ipl_ver;
+extern volatile nyx_storage_t *nyx_str;
 
 void set_default_configuration()
 {
@@ -44,12 +48,14 @@ void set_default_configuration()
 	h_cfg.autonogc = 1;
 	h_cfg.updater2p = 0;
 	h_cfg.bootprotect = 0;
+	h_cfg.boottrace = 0;
 	h_cfg.errors = 0;
 	h_cfg.eks = NULL;
 	h_cfg.sept_run = EMC(EMC_SCRATCH0) & EMC_SEPT_RUN;
 	h_cfg.aes_slots_new = false;
 	h_cfg.rcm_patched = fuse_check_patched_rcm();
 	h_cfg.emummc_force_disable = false;
+	h_cfg.display_on = false;
 	h_cfg.t210b01 = hw_get_chip_id() == GP_HIDREV_MAJOR_T210B01;
 }
 
@@ -84,6 +90,7 @@ int create_config_entry()
 		}
 	}
 
+	ini_arena_drop("bootloader/hekate_ipl.ini");
 	if (f_open(&fp, "bootloader/hekate_ipl.ini", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
 		return 1;
 	// Add config entry.
@@ -111,6 +118,9 @@ int create_config_entry()
 	f_puts("\nbootprotect=", &fp);
 	itoa(h_cfg.bootprotect, lbuf, 10);
 	f_puts(lbuf, &fp);
+	f_puts("\nboottrace=", &fp);
+	itoa(h_cfg.boottrace, lbuf, 10);
+	f_puts(lbuf, &fp);
 	f_puts("\n", &fp);
 
 	if (mainIniFound)
@@ -159,6 +169,175 @@ int create_config_entry()
 	return 0;
 }
 
+#define BOOT_CACHE_PATH     "bootloader/autoboot_cache.bin"
+#define BOOT_CACHE_MAGIC    0x43544241 // "ABTC".
+#define BOOT_CACHE_DATA_MAX 0x1000
+
+typedef struct _boot_cache_hdr_t
+{
+	u32 magic;
+	u32 version;   // hekate version that compiled it.
+	u32 ini_size;  // hekate_ipl.ini size.
+	u32 ini_crc;   // hekate_ipl.ini CRC32.
+	u32 disp_id;   // Raw display panel ID.
+	u32 autoboot;
+	u32 backlight;
+	u32 autohosoff;
+	u32 autonogc;
+	u32 updater2p;
+	u32 bootprotect;
+	u32 boottrace;
+	u32 data_size; // Boot entry name, then key/value pairs. All NUL terminated.
+	u32 data_crc;
+} boot_cache_hdr_t;
+
+static bool _boot_cache_ini_stamp(boot_cache_hdr_t *hdr)
+{
+	// Read once into the config arena, which keeps size and CRC32 of the raw file.
+	return ini_arena_stamp("bootloader/hekate_ipl.ini", &hdr->ini_size, &hdr->ini_crc);
+}
+
+static u32 _boot_cache_put_str(char *data, u32 pos, const char *str)
+{
+	u32 len = strlen(str) + 1;
+
+	// Oversized entries are not cached.
+	if (pos + len > BOOT_CACHE_DATA_MAX)
+		return BOOT_CACHE_DATA_MAX + 1;
+
+	memcpy(data + pos, str, len);
+
+	return pos + len;
+}
+
+ini_sec_t *boot_cache_load()
+{
+	boot_cache_hdr_t hdr;
+	boot_cache_hdr_t ini;
+	ini_sec_t *cfg_sec = NULL;
+	char *data = NULL;
+	FIL fp;
+	UINT br;
+
+	if (f_open(&fp, BOOT_CACHE_PATH, FA_READ))
+		return NULL;
+
+	if (f_read(&fp, &hdr, sizeof(hdr), &br) || br != sizeof(hdr) ||
+		hdr.magic != BOOT_CACHE_MAGIC || hdr.version != ipl_ver.version ||
+		!hdr.data_size || hdr.data_size > BOOT_CACHE_DATA_MAX)
+		goto out;
+
+	// Must be compiled from the current hekate_ipl.ini.
+	if (!_boot_cache_ini_stamp(&ini) || ini.ini_size != hdr.ini_size || ini.ini_crc != hdr.ini_crc)
+		goto out;
+
+	data = (char *)malloc(hdr.data_size);
+	if (f_read(&fp, data, hdr.data_size, &br) || br != hdr.data_size || data[hdr.data_size - 1] ||
+		crc32_calc(0, (u8 *)data, hdr.data_size) != hdr.data_crc)
+		goto out;
+
+	// Rebuild the boot entry. All strings point into the cache data.
+	cfg_sec = (ini_sec_t *)calloc(sizeof(ini_sec_t), 1);
+	cfg_sec->name = data;
+	cfg_sec->type = INI_CHOICE;
+	list_init(&cfg_sec->kvs);
+
+	char *str = data + strlen(data) + 1;
+	char *end = data + hdr.data_size;
+	while (str < end)
+	{
+		ini_kv_t *kv = (ini_kv_t *)calloc(sizeof(ini_kv_t), 1);
+		kv->key = str;
+		str += strlen(str) + 1;
+		kv->val = str < end ? str : "";
+		str += strlen(kv->val) + 1;
+		list_append(&cfg_sec->kvs, &kv->link);
+	}
+
+	// Apply global config. Only entries with no boot delay are cached.
+	h_cfg.autoboot = hdr.autoboot;
+	h_cfg.autoboot_list = 0;
+	h_cfg.bootwait = 0;
+	h_cfg.backlight = hdr.backlight;
+	h_cfg.autohosoff = hdr.autohosoff;
+	h_cfg.autonogc = hdr.autonogc;
+	h_cfg.updater2p = hdr.updater2p;
+	h_cfg.bootprotect = hdr.bootprotect;
+	h_cfg.boottrace = hdr.boottrace;
+
+	// The panel is not probed until the display is needed.
+	nyx_str->info.disp_id = hdr.disp_id;
+	display_set_decoded_panel_id(hdr.disp_id);
+
+out:
+	f_close(&fp);
+	if (!cfg_sec)
+		free(data);
+
+	return cfg_sec;
+}
+
+void boot_cache_save(ini_sec_t *cfg_sec)
+{
+	boot_cache_hdr_t hdr;
+	boot_cache_hdr_t old;
+	FIL fp;
+	UINT br;
+
+	memset(&hdr, 0, sizeof(hdr));
+	if (!_boot_cache_ini_stamp(&hdr))
+		return;
+
+	// Flatten the boot entry.
+	char *data = (char *)malloc(BOOT_CACHE_DATA_MAX);
+	u32 size = _boot_cache_put_str(data, 0, cfg_sec->name);
+	LIST_FOREACH_ENTRY(ini_kv_t, kv, &cfg_sec->kvs, link)
+	{
+		size = _boot_cache_put_str(data, size, kv->key);
+		size = _boot_cache_put_str(data, size, kv->val);
+	}
+
+	if (size > BOOT_CACHE_DATA_MAX)
+		goto out;
+
+	hdr.magic = BOOT_CACHE_MAGIC;
+	hdr.version = ipl_ver.version;
+	hdr.disp_id = nyx_str->info.disp_id;
+	hdr.autoboot = h_cfg.autoboot;
+	hdr.backlight = h_cfg.backlight;
+	hdr.autohosoff = h_cfg.autohosoff;
+	hdr.autonogc = h_cfg.autonogc;
+	hdr.updater2p = h_cfg.updater2p;
+	hdr.bootprotect = h_cfg.bootprotect;
+	hdr.boottrace = h_cfg.boottrace;
+	hdr.data_size = size;
+	hdr.data_crc = crc32_calc(0, (u8 *)data, size);
+
+	// Skip the write if nothing changed.
+	if (!f_open(&fp, BOOT_CACHE_PATH, FA_READ))
+	{
+		bool same = !f_read(&fp, &old, sizeof(old), &br) && br == sizeof(old) && !memcmp(&old, &hdr, sizeof(hdr));
+		f_close(&fp);
+
+		if (same)
+			goto out;
+	}
+
+	if (f_open(&fp, BOOT_CACHE_PATH, FA_CREATE_ALWAYS | FA_WRITE))
+		goto out;
+
+	bool ok = !f_write(&fp, &hdr, sizeof(hdr), &br) && br == sizeof(hdr) &&
+		!f_write(&fp, data, size, &br) && br == size;
+	f_close(&fp);
+
+	// Never leave a partial cache behind.
+	if (!ok)
+		f_unlink(BOOT_CACHE_PATH);
+
+out:
+	free(data);
+}
+
 #pragma GCC push_options
 #pragma GCC optimize ("Os")
 
@@ -31,6 +31,7 @@ typedef struct _hekate_config
 	u32 autonogc;
 	u32 updater2p;
 	u32 bootprotect;
+	u32 boottrace;
 	// Global temporary config.
 	bool t210b01;
 	bool se_keygen_done;
@@ -38,6 +39,7 @@ typedef struct _hekate_config
 	bool aes_slots_new;
 	bool emummc_force_disable;
 	bool rcm_patched;
+	bool display_on;
 	u32  errors;
 	hos_eks_mbr_t *eks;
 } hekate_config;
@@ -49,5 +51,7 @@ void config_bootdelay();
 void config_backlight();
 void config_auto_hos_poweroff();
 void config_nogc();
+ini_sec_t *boot_cache_load();
+void boot_cache_save(ini_sec_t *cfg_sec);
 
 #endif /* _CONFIG_H_ */
@@ -180,17 +180,17 @@ static int _dump_emmc_part(char *sd_path, sdmmc_storage_t *storage, emmc_part_t
 
 	gfx_con.fntsz = 8;
 	gfx_printf("\nSpazio libero scheda SD: %d MiB, Dimensione totale backup %d MiB\n\n",
-		sd_fs.free_clst * sd_fs.csize >> SECTORS_TO_MIB_COEFF,
+		sd_fs->free_clst * sd_fs->csize >> SECTORS_TO_MIB_COEFF,
 		totalSectors >> SECTORS_TO_MIB_COEFF);
 
 	// 1GB parts for sd cards 8GB and less.
 	if ((sd_storage.csd.capacity >> (20 - sd_storage.csd.read_blkbits)) <= 8192)
 		multipartSplitSize = (1u << 30);
 	// Maximum parts fitting the free space available.
-	maxSplitParts = (sd_fs.free_clst * sd_fs.csize) / (multipartSplitSize / NX_EMMC_BLOCKSIZE);
+	maxSplitParts = (sd_fs->free_clst * sd_fs->csize) / (multipartSplitSize / NX_EMMC_BLOCKSIZE);
 
 	// Check if the USER partition or the RAW eMMC fits the sd card free space.
-	if (totalSectors > (sd_fs.free_clst * sd_fs.csize))
+	if (totalSectors > (sd_fs->free_clst * sd_fs->csize))
 	{
 		isSmallSdCard = true;
 
@@ -231,7 +231,7 @@ static int _dump_emmc_part(char *sd_path, sdmmc_storage_t *storage, emmc_part_t
 		gfx_printf("%kBackup parziale attivato (con parti di %d MiB)...%k\n\n", 0xFFFFBA00, multipartSplitSize >> 20, 0xFFCCCCCC);
 
 	// Check if filesystem is FAT32 or the free space is smaller and backup in parts.
-	if (((sd_fs.fs_type != FS_EXFAT) && totalSectors > (FAT32_FILESIZE_LIMIT / NX_EMMC_BLOCKSIZE)) || isSmallSdCard)
+	if (((sd_fs->fs_type != FS_EXFAT) && totalSectors > (FAT32_FILESIZE_LIMIT / NX_EMMC_BLOCKSIZE)) || isSmallSdCard)
 	{
 		u32 multipartSplitSectors = multipartSplitSize / NX_EMMC_BLOCKSIZE;
 		numSplitParts = (totalSectors + multipartSplitSectors - 1) / multipartSplitSectors;
@@ -285,7 +285,7 @@ static int _dump_emmc_part(char *sd_path, sdmmc_storage_t *storage, emmc_part_t
 		lbaStartPart = lba_curr; // Update the start LBA for verification.
 	}
 	u64 totalSize = (u64)((u64)totalSectors << 9);
-	if (!isSmallSdCard && (sd_fs.fs_type == FS_EXFAT || totalSize <= FAT32_FILESIZE_LIMIT))
+	if (!isSmallSdCard && (sd_fs->fs_type == FS_EXFAT || totalSize <= FAT32_FILESIZE_LIMIT))
 		f_lseek(&fp, totalSize);
 	else
 		f_lseek(&fp, MIN(totalSize, multipartSplitSize));
@@ -476,7 +476,7 @@ static void _dump_emmc_selected(emmcPartType_t dumpType)
 
 	gfx_puts("Verificando lo spazio libero...\n\n");
 	// Get SD Card free space for Partial Backup.
-	f_getfree("", &sd_fs.free_clst, NULL);
+	f_getfree("", &sd_fs->free_clst, NULL);
 
 	sdmmc_storage_t storage;
 	sdmmc_t sdmmc;
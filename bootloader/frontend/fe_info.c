@@ -296,14 +296,14 @@ void print_sdcard_info()
 			sd_storage.ssr.app_class, sd_storage.csd.write_protect,
 			sd_errors[0], sd_errors[1], sd_errors[2]); // SD_ERROR_INIT_FAIL, SD_ERROR_RW_FAIL, SD_ERROR_RW_RETRY.
 
-		int res = f_mount(&sd_fs, "", 1);
+		int res = f_mount(sd_fs, "", 1);
 		if (!res)
 		{
 			gfx_puts("Acquisendo informazioni del volume FAT...\n\n");
-			f_getfree("", &sd_fs.free_clst, NULL);
+			f_getfree("", &sd_fs->free_clst, NULL);
 			gfx_printf("%kTrovato volume %s:%k\n Liberi:    %d MiB\n Cluster: %d KiB\n",
-					0xFF00DDFF, sd_fs.fs_type == FS_EXFAT ? "exFAT" : "FAT32", 0xFFCCCCCC,
-					sd_fs.free_clst * sd_fs.csize >> SECTORS_TO_MIB_COEFF, (sd_fs.csize > 1) ? (sd_fs.csize >> 1) : 512);
+					0xFF00DDFF, sd_fs->fs_type == FS_EXFAT ? "exFAT" : "FAT32", 0xFFCCCCCC,
+					sd_fs->free_clst * sd_fs->csize >> SECTORS_TO_MIB_COEFF, (sd_fs->csize > 1) ? (sd_fs->csize >> 1) : 512);
 			f_mount(NULL, "", 1);
 		}
 		else
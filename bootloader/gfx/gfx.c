@@ -18,6 +18,9 @@
 #include <stdarg.h>
 #include <string.h>
 #include "gfx.h"
+#include <mem/heap.h>
+
+#define GFX_CON_DEFER_BUF_SZ 0x4000
 
 // Global gfx console and context.
 gfx_ctxt_t gfx_ctxt;
@@ -25,6 +28,29 @@ gfx_con_t gfx_con;
 
 static bool gfx_con_init_done = false;
 
+// Glyph row nibble to 4 pixels lookup, for the current colors.
+static u32 _gfx_nibble_px[16][4];
+static u32 _gfx_nibble_fgcol = 0;
+static u32 _gfx_nibble_bgcol = 0;
+
+// A run of printable chars, recorded while the console is deferred.
+typedef struct _gfx_con_run_t
+{
+	u16 x;
+	u16 y;
+	u32 fgcol;
+	u32 bgcol;
+	u8  fntsz;
+	u8  fillbg;
+	u16 len;
+	char text[];
+} gfx_con_run_t;
+
+static bool gfx_con_deferred = false;
+static u8  *gfx_con_defer_buf = NULL;
+static u32  gfx_con_defer_pos = 0;
+static gfx_con_run_t *gfx_con_defer_run = NULL;
+
 static const u8 _gfx_font[] = {
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Char 032 ( )
 	0x00, 0x30, 0x30, 0x18, 0x18, 0x00, 0x0C, 0x00, // Char 033 (!)
@@ -182,86 +208,164 @@ void gfx_con_setpos(u32 x, u32 y)
 	gfx_con.y = y;
 }
 
-void gfx_putc(char c)
+static void _gfx_update_nibble_px(u32 fgcol, u32 bgcol)
+{
+	if (_gfx_nibble_fgcol == fgcol && _gfx_nibble_bgcol == bgcol)
+		return;
+
+	for (u32 n = 0; n < 16; n++)
+		for (u32 j = 0; j < 4; j++)
+			_gfx_nibble_px[n][j] = (n & BIT(j)) ? fgcol : bgcol;
+
+	_gfx_nibble_fgcol = fgcol;
+	_gfx_nibble_bgcol = bgcol;
+}
+
+static void _gfx_render_run(const char *s, u32 len, u32 x, u32 y, u32 fntsz, u32 fgcol, int fillbg, u32 bgcol)
 {
-	// Duplicate code for performance reasons.
-	switch (gfx_con.fntsz)
+	// Render the whole run one framebuffer line at a time.
+	u32 scale = (fntsz == 16) ? 2 : 1;
+	u32 *fb_line = gfx_ctxt.fb + x + y * gfx_ctxt.stride;
+
+	if (fillbg)
+		_gfx_update_nibble_px(fgcol, bgcol);
+
+	for (u32 i = 0; i < 8; i++)
 	{
-	case 16:
-		if (c >= 32 && c <= 126)
+		for (u32 k = 0; k < scale; k++)
 		{
-			u8 *cbuf = (u8 *)&_gfx_font[8 * (c - 32)];
-			u32 *fb = gfx_ctxt.fb + gfx_con.x + gfx_con.y * gfx_ctxt.stride;
+			u32 *fb = fb_line;
 
-			for (u32 i = 0; i < 16; i += 2)
+			for (u32 c = 0; c < len; c++)
 			{
-				u8 v = *cbuf;
-				for (u32 k = 0; k < 2; k++)
+				u8 v = _gfx_font[8 * (s[c] - 32) + i];
+
+				if (fillbg)
 				{
+					// Expand each glyph row nibble to a pixel run.
+					const u32 *lo = _gfx_nibble_px[v & 0xF];
+					const u32 *hi = _gfx_nibble_px[v >> 4];
+					if (scale == 1)
+					{
+						fb[0] = lo[0]; fb[1] = lo[1]; fb[2] = lo[2]; fb[3] = lo[3];
+						fb[4] = hi[0]; fb[5] = hi[1]; fb[6] = hi[2]; fb[7] = hi[3];
+					}
+					else
+					{
+						fb[0]  = lo[0]; fb[1]  = lo[0]; fb[2]  = lo[1]; fb[3]  = lo[1];
+						fb[4]  = lo[2]; fb[5]  = lo[2]; fb[6]  = lo[3]; fb[7]  = lo[3];
+						fb[8]  = hi[0]; fb[9]  = hi[0]; fb[10] = hi[1]; fb[11] = hi[1];
+						fb[12] = hi[2]; fb[13] = hi[2]; fb[14] = hi[3]; fb[15] = hi[3];
+					}
+					fb += fntsz;
+				}
+				else
+				{
+					// Transparent background. Only draw set pixels.
 					for (u32 j = 0; j < 8; j++)
 					{
 						if (v & 1)
 						{
-							*fb = gfx_con.fgcol;
-							fb++;
-							*fb = gfx_con.fgcol;
-						}
-						else if (gfx_con.fillbg)
-						{
-							*fb = gfx_con.bgcol;
-							fb++;
-							*fb = gfx_con.bgcol;
+							*fb = fgcol;
+							if (scale == 2)
+								fb[1] = fgcol;
 						}
-						else
-							fb++;
 						v >>= 1;
-						fb++;
+						fb += scale;
 					}
-					fb += gfx_ctxt.stride - 16;
-					v = *cbuf;
-				}
-				cbuf++;
-			}
-			gfx_con.x += 16;
-		}
-		else if (c == '\n')
-		{
-			gfx_con.x = 0;
-			gfx_con.y += 16;
-			if (gfx_con.y > gfx_ctxt.height - 16)
-				gfx_con.y = 0;
-		}
-		break;
-	case 8:
-	default:
-		if (c >= 32 && c <= 126)
-		{
-			u8 *cbuf = (u8 *)&_gfx_font[8 * (c - 32)];
-			u32 *fb = gfx_ctxt.fb + gfx_con.x + gfx_con.y * gfx_ctxt.stride;
-			for (u32 i = 0; i < 8; i++)
-			{
-				u8 v = *cbuf++;
-				for (u32 j = 0; j < 8; j++)
-				{
-					if (v & 1)
-						*fb = gfx_con.fgcol;
-					else if (gfx_con.fillbg)
-						*fb = gfx_con.bgcol;
-					v >>= 1;
-					fb++;
 				}
-				fb += gfx_ctxt.stride - 8;
 			}
-			gfx_con.x += 8;
-		}
-		else if (c == '\n')
-		{
-			gfx_con.x = 0;
-			gfx_con.y += 8;
-			if (gfx_con.y > gfx_ctxt.height - 8)
-				gfx_con.y = 0;
+
+			fb_line += gfx_ctxt.stride;
 		}
-		break;
+	}
+}
+
+void gfx_con_flush()
+{
+	u32 pos = 0;
+
+	while (pos < gfx_con_defer_pos)
+	{
+		gfx_con_run_t *run = (gfx_con_run_t *)(gfx_con_defer_buf + pos);
+		_gfx_render_run(run->text, run->len, run->x, run->y, run->fntsz, run->fgcol, run->fillbg, run->bgcol);
+		pos += ALIGN(sizeof(gfx_con_run_t) + run->len, 4);
+	}
+
+	gfx_con_defer_pos = 0;
+	gfx_con_defer_run = NULL;
+}
+
+void gfx_con_defer(bool enable)
+{
+	if (enable && !gfx_con_defer_buf)
+		gfx_con_defer_buf = (u8 *)malloc(GFX_CON_DEFER_BUF_SZ);
+
+	if (!enable)
+		gfx_con_flush();
+
+	gfx_con_deferred = enable;
+}
+
+static void _gfx_defer_run(const char *s, u32 len, u32 fntsz)
+{
+	gfx_con_run_t *run = gfx_con_defer_run;
+
+	// Extend the last run if the text continues it with the same attributes.
+	if (run &&
+		run->y == gfx_con.y && run->x + run->len * fntsz == gfx_con.x &&
+		run->fntsz == fntsz && run->fgcol == gfx_con.fgcol &&
+		run->fillbg == (gfx_con.fillbg ? 1 : 0) && (!run->fillbg || run->bgcol == gfx_con.bgcol) &&
+		((u8 *)run - gfx_con_defer_buf) + ALIGN(sizeof(gfx_con_run_t) + run->len + len, 4) <= GFX_CON_DEFER_BUF_SZ)
+	{
+		memcpy(run->text + run->len, s, len);
+		run->len += len;
+		gfx_con_defer_pos = (u8 *)run - gfx_con_defer_buf + ALIGN(sizeof(gfx_con_run_t) + run->len, 4);
+
+		return;
+	}
+
+	if (gfx_con_defer_pos + ALIGN(sizeof(gfx_con_run_t) + len, 4) > GFX_CON_DEFER_BUF_SZ)
+		gfx_con_flush();
+
+	run = (gfx_con_run_t *)(gfx_con_defer_buf + gfx_con_defer_pos);
+	run->x = gfx_con.x;
+	run->y = gfx_con.y;
+	run->fgcol = gfx_con.fgcol;
+	run->bgcol = gfx_con.bgcol;
+	run->fntsz = fntsz;
+	run->fillbg = gfx_con.fillbg ? 1 : 0;
+	run->len = len;
+	memcpy(run->text, s, len);
+
+	gfx_con_defer_pos += ALIGN(sizeof(gfx_con_run_t) + len, 4);
+	gfx_con_defer_run = run;
+}
+
+static void _gfx_put_run(const char *s, u32 len)
+{
+	u32 fntsz = (gfx_con.fntsz == 16) ? 16 : 8;
+
+	if (gfx_con_deferred && gfx_con_defer_buf && len <= GFX_CON_DEFER_BUF_SZ / 2)
+		_gfx_defer_run(s, len, fntsz);
+	else
+		_gfx_render_run(s, len, gfx_con.x, gfx_con.y, fntsz, gfx_con.fgcol, gfx_con.fillbg, gfx_con.bgcol);
+
+	gfx_con.x += len * fntsz;
+}
+
+void gfx_putc(char c)
+{
+	u32 fntsz = (gfx_con.fntsz == 16) ? 16 : 8;
+
+	if (c >= 32 && c <= 126)
+		_gfx_put_run(&c, 1);
+	else if (c == '\n')
+	{
+		gfx_con.x = 0;
+		gfx_con.y += fntsz;
+		if (gfx_con.y > gfx_ctxt.height - fntsz)
+			gfx_con.y = 0;
 	}
 }
 
@@ -270,8 +374,24 @@ void gfx_puts(char *s)
 	if (!s || !gfx_con_init_done || gfx_con.mute)
 		return;
 
-	for (; *s; s++)
-		gfx_putc(*s);
+	while (*s)
+	{
+		// Render printable chars as a run.
+		u32 len = 0;
+		while (s[len] >= 32 && s[len] <= 126)
+			len++;
+
+		if (len)
+		{
+			_gfx_put_run(s, len);
+			s += len;
+		}
+		else
+		{
+			gfx_putc(*s);
+			s++;
+		}
+	}
 }
 
 static void _gfx_putn(u32 v, int base, char fill, int fcnt)
@@ -389,7 +509,20 @@ void gfx_printf(const char *fmt, ...)
 			}
 		}
 		else
-			gfx_putc(*fmt);
+		{
+			// Render plain text up to the next format specifier as a run.
+			u32 len = 0;
+			while (fmt[len] >= 32 && fmt[len] <= 126 && fmt[len] != '%')
+				len++;
+
+			if (len)
+			{
+				_gfx_put_run(fmt, len);
+				fmt += len - 1;
+			}
+			else
+				gfx_putc(*fmt);
+		}
 		fmt++;
 	}
 
@@ -60,6 +60,8 @@ void gfx_con_init();
 void gfx_con_setcol(u32 fgcol, int fillbg, u32 bgcol);
 void gfx_con_getpos(u32 *x, u32 *y);
 void gfx_con_setpos(u32 x, u32 y);
+void gfx_con_defer(bool enable);
+void gfx_con_flush();
 void gfx_putc(char c);
 void gfx_puts(char *s);
 void gfx_printf(const char *fmt, ...);
@@ -37,6 +37,8 @@ extern bool is_ipl_updated(void *buf, char *path, bool force);
 #define FSS0_MAGIC 0x30535346
 #define FSS0_META_OFFSET 0x4
 #define FSS0_VERSION_0_17_0 0x110000
+#define FSS0_HDR_SIZE 0x400
+#define FSS0_CNT_MAX 128
 
 // FSS0 Content Types.
 #define CNT_TYPE_FSP 0
@@ -116,9 +118,25 @@ static void _update_r2p(launch_ctxt_t *ctxt, const char *path)
 	free(r2p_path);
 }
 
+static void *_fss_read_content(FIL *fp, fss_content_t *cnt, void *dst)
+{
+	UINT br;
+	void *buf = dst ? dst : malloc(cnt->size);
+
+	if (f_lseek(fp, cnt->offset) != FR_OK || f_read(fp, buf, cnt->size, &br) != FR_OK || br != cnt->size)
+	{
+		if (!dst)
+			free(buf);
+		return NULL;
+	}
+
+	return buf;
+}
+
 int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 {
 	FIL fp;
+	UINT br;
 
 	bool stock = false;
 	int sept_used = 0;
@@ -147,13 +165,17 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 	if (f_open(&fp, path, FA_READ) != FR_OK)
 		return 0;
 
-	void *fss = malloc(f_size(&fp));
+	// Only the header and content table are read here. Contents are read on demand below.
+	u8 *fss = (u8 *)calloc(FSS0_HDR_SIZE, 1);
+	fss_content_t *curr_fss_cnt = NULL;
 
 	// Read first 1024 bytes of the fss file.
-	f_read(&fp, fss, 1024, NULL);
+	f_read(&fp, fss, FSS0_HDR_SIZE, NULL);
 
 	// Get FSS0 Meta header offset.
 	u32 fss_meta_addr = *(u32 *)(fss + FSS0_META_OFFSET);
+	if (fss_meta_addr > FSS0_HDR_SIZE - sizeof(fss_meta_t))
+		goto fail;
 	fss_meta_t *fss_meta = (fss_meta_t *)(fss + fss_meta_addr);
 
 	// Check if valid FSS0 and parse it.
@@ -178,6 +200,16 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 			goto fail;
 		}
 
+		if (fss_meta->cnt_count > FSS0_CNT_MAX)
+			goto fail;
+
+		// Read the content table.
+		u32 cnt_size = fss_meta->cnt_count * sizeof(fss_content_t);
+		curr_fss_cnt = (fss_content_t *)malloc(cnt_size);
+		f_lseek(&fp, fss_meta->cnt_off);
+		if (f_read(&fp, curr_fss_cnt, cnt_size, &br) != FR_OK || br != cnt_size)
+			goto fail;
+
 		if (!sept_ctxt)
 		{
 			ctxt->atmosphere = true;
@@ -185,14 +217,13 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 		}
 
 		// Parse FSS0 contents.
-		fss_content_t *curr_fss_cnt = (fss_content_t *)(fss + fss_meta->cnt_off);
 		void *content;
+		merge_kip_t *mkip1;
 		for (u32 i = 0; i < fss_meta->cnt_count; i++)
 		{
-			content = (void *)(fss + curr_fss_cnt[i].offset);
-
 			// Check if offset is inside limits.
-			if ((curr_fss_cnt[i].offset + curr_fss_cnt[i].size) > fss_meta->size)
+			if (curr_fss_cnt[i].size > fss_meta->size ||
+				curr_fss_cnt[i].offset > fss_meta->size - curr_fss_cnt[i].size)
 				continue;
 
 			// If content is experimental and experimental flag is not enabled, skip it.
@@ -202,21 +233,49 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 			// Parse content.
 			if (!sept_ctxt)
 			{
-				// Prepare content context.
+				// Skip contents that won't be used, before reading anything.
 				switch (curr_fss_cnt[i].type)
 				{
 				case CNT_TYPE_KIP:
+				case CNT_TYPE_KRN:
 					if (stock)
 						continue;
-					merge_kip_t *mkip1 = (merge_kip_t *)malloc(sizeof(merge_kip_t));
+					break;
+
+				case CNT_TYPE_EXO:
+					break;
+
+				case CNT_TYPE_EXF:
+					// Mariko fatal payload.
+					if (!h_cfg.t210b01)
+						continue;
+					break;
+
+				case CNT_TYPE_WBT:
+					if (h_cfg.t210b01)
+						continue;
+					break;
+
+				default:
+					continue;
+				}
+
+				// Load content into its own buffer.
+				content = _fss_read_content(&fp, &curr_fss_cnt[i], NULL);
+				if (!content)
+					goto fail;
+
+				// Prepare content context.
+				switch (curr_fss_cnt[i].type)
+				{
+				case CNT_TYPE_KIP:
+					mkip1 = (merge_kip_t *)malloc(sizeof(merge_kip_t));
 					mkip1->kip1 = content;
 					list_append(&ctxt->kip1_list, &mkip1->link);
 					DPRINTF("Caricato %s.kip1 da FSS0 (dimensione %08X)\n", curr_fss_cnt[i].name, curr_fss_cnt[i].size);
 					break;
 
 				case CNT_TYPE_KRN:
-					if (stock)
-						continue;
 					ctxt->kernel_size = curr_fss_cnt[i].size;
 					ctxt->kernel = content;
 					break;
@@ -232,19 +291,10 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 					break;
 
 				case CNT_TYPE_WBT:
-					if (h_cfg.t210b01)
-						continue;
 					ctxt->warmboot_size = curr_fss_cnt[i].size;
 					ctxt->warmboot = content;
 					break;
-
-				default:
-					continue;
 				}
-
-				// Load content to launch context.
-				f_lseek(&fp, curr_fss_cnt[i].offset);
-				f_read(&fp, content, curr_fss_cnt[i].size, NULL);
 			}
 			else
 			{
@@ -252,14 +302,14 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 				switch (curr_fss_cnt[i].type)
 				{
 				case CNT_TYPE_SP1:
-					f_lseek(&fp, curr_fss_cnt[i].offset);
-					f_read(&fp, sept_ctxt->sept_primary, curr_fss_cnt[i].size, NULL);
+					if (!_fss_read_content(&fp, &curr_fss_cnt[i], sept_ctxt->sept_primary))
+						goto fail;
 					break;
 				case CNT_TYPE_SP2:
 					if (!memcmp(curr_fss_cnt[i].name, (sept_ctxt->kb < KB_FIRMWARE_VERSION_810) ? "septsecondary00" : "septsecondary01", 15))
 					{
-						f_lseek(&fp, curr_fss_cnt[i].offset);
-						f_read(&fp, sept_ctxt->sept_secondary, curr_fss_cnt[i].size, NULL);
+						if (!_fss_read_content(&fp, &curr_fss_cnt[i], sept_ctxt->sept_secondary))
+							goto fail;
 						sept_used = 1;
 						goto out;
 					}
@@ -273,6 +323,8 @@ int parse_fss(launch_ctxt_t *ctxt, const char *path, fss0_sept_t *sept_ctxt)
 out:
 		gfx_printf("Fatto!\n");
 		f_close(&fp);
+		free(curr_fss_cnt);
+		free(fss);
 
 		_update_r2p(ctxt, path);
 
@@ -281,6 +333,7 @@ out:
 
 fail:
 	f_close(&fp);
+	free(curr_fss_cnt);
 	free(fss);
 
 	return 0;
@@ -46,10 +46,13 @@
 #include <storage/nx_sd.h>
 #include <storage/sdmmc.h>
 #include <utils/btn.h>
+#include <utils/btrace.h>
 #include <utils/util.h>
 
 extern hekate_config h_cfg;
 
+extern void ipl_display_init();
+
 //#define DPRINTF(...) gfx_printf(__VA_ARGS__)
 #define DPRINTF(...)
 
@@ -625,6 +628,7 @@ try_load:
 	return 1;
 }
 
+// Starts the package2 read. Its body is transferred in the background on sysMMC.
 static u8 *_read_emmc_pkg2(launch_ctxt_t *ctxt)
 {
 	u8 *bctBuf = NULL;
@@ -655,10 +659,24 @@ DPRINTF("pkg2 size on emmc is %08X\n", pkg2_size);
 	// Read in package2.
 	u32 pkg2_size_aligned = ALIGN(pkg2_size, NX_EMMC_BLOCKSIZE);
 DPRINTF("pkg2 size aligned is %08X\n", pkg2_size_aligned);
+	u32 pkg2_sector = pkg2_part->lba_start + BCT_SIZE / NX_EMMC_BLOCKSIZE;
+	u32 pkg2_sectors = pkg2_size_aligned / NX_EMMC_BLOCKSIZE;
+
+	// The raw read has no partition bounds check. The last LBA is inclusive.
+	if (!pkg2_sectors || pkg2_sectors > pkg2_part->lba_end - pkg2_sector + 1)
+	{
+		free(bctBuf);
+		bctBuf = NULL;
+		goto out;
+	}
+
 	ctxt->pkg2 = malloc(pkg2_size_aligned);
 	ctxt->pkg2_size = pkg2_size;
-	nx_emmc_part_read(&emmc_storage, pkg2_part, BCT_SIZE / NX_EMMC_BLOCKSIZE,
-		pkg2_size_aligned / NX_EMMC_BLOCKSIZE, ctxt->pkg2);
+	if (!emummc_storage_read_async(pkg2_sector, pkg2_sectors, ctxt->pkg2))
+	{
+		free(bctBuf);
+		bctBuf = NULL;
+	}
 out:
 	nx_emmc_gpt_free(&gpt);
 
@@ -672,6 +690,7 @@ static void _free_launch_components(launch_ctxt_t *ctxt)
 	free(ctxt->pkg2);
 	free(ctxt->warmboot);
 	free(ctxt->secmon);
+	free(ctxt->exofatal);
 	free(ctxt->kernel);
 	free(ctxt->kip1_patches);
 }
@@ -726,6 +745,8 @@ int hos_launch(ini_sec_t *cfg)
 	tsec_ctxt_t tsec_ctxt;
 	volatile secmon_mailbox_t *secmon_mailbox;
 
+	btrace_begin(BT_HOS_LAUNCH);
+
 	minerva_change_freq(FREQ_1600);
 	memset(&ctxt, 0, sizeof(launch_ctxt_t));
 	memset(&tsec_ctxt, 0, sizeof(tsec_ctxt_t));
@@ -737,10 +758,15 @@ int hos_launch(ini_sec_t *cfg)
 		gfx_clear_grey(0x1B);
 	gfx_con_setpos(0, 0);
 
+	// Batch console output. It's flushed before waiting for input and on exit.
+	gfx_con_defer(true);
+
 	gfx_puts("Inizializzazione...\n\n");
 
 	// Initialize eMMC/emuMMC.
+	btrace_begin(BT_EMMC_INIT);
 	int res = emummc_storage_init_mmc();
+	btrace_end(BT_EMMC_INIT);
 	if (res)
 	{
 		if (res == 2)
@@ -756,17 +782,30 @@ int hos_launch(ini_sec_t *cfg)
 		_hos_crit_error("La scheda SD ha solo GPT!");
 
 	// Read package1 and the correct keyblob.
+	btrace_begin(BT_PKG1_READ);
 	if (!_read_emmc_pkg1(&ctxt))
 		goto error;
+	btrace_end(BT_PKG1_READ);
+
+	// Start reading package2. On sysMMC it streams while FSS0 and kips load from SD.
+	btrace_begin(BT_PKG2_READ);
+	u8 *bootConfigBuf = _read_emmc_pkg2(&ctxt);
+	if (!bootConfigBuf)
+	{
+		_hos_crit_error("Lettura di Pkg2 fallita!");
+		goto error;
+	}
 
 	kb = ctxt.pkg1_id->kb;
 
 	// Try to parse config if present.
+	btrace_begin(BT_BOOT_CFG);
 	if (ctxt.cfg && !parse_boot_config(&ctxt))
 	{
 		_hos_crit_error("File ini di configurazione sbagliato o file mancanti!");
 		goto error;
 	}
+	btrace_end(BT_BOOT_CFG);
 
 	bool emummc_enabled = emu_cfg.enabled && !h_cfg.emummc_force_disable;
 
@@ -835,14 +874,17 @@ int hos_launch(ini_sec_t *cfg)
 			goto error;
 		}
 
+		btrace_begin(BT_KEYGEN);
 		if (!hos_keygen(ctxt.keyblob, kb, &tsec_ctxt, &ctxt))
 			goto error;
+		btrace_end(BT_KEYGEN);
 		gfx_puts("Chiavi generate\n");
 		if (kb <= KB_FIRMWARE_VERSION_600)
 			h_cfg.se_keygen_done = 1;
 	}
 
 	// Decrypt and unpack package1 if we require parts of it.
+	btrace_begin(BT_PKG1_UNPACK);
 	if (!ctxt.warmboot || !ctxt.secmon)
 	{
 		// Decrypt PK1 or PK11.
@@ -885,6 +927,8 @@ int hos_launch(ini_sec_t *cfg)
 		_hos_crit_error("I fuses non corrispondono al warmboot!\nSe prosegui, non funzionera' la modalita' riposo!");
 
 		gfx_puts("\nPremi POWER per continuare.\nPremi VOL per andare al menu'.\n");
+		gfx_con_flush();
+		ipl_display_init();
 		display_backlight_brightness(h_cfg.backlight, 1000);
 
 		if (!(btn_wait() & BTN_POWER))
@@ -912,20 +956,24 @@ int hos_launch(ini_sec_t *cfg)
 	else
 		pkg1_secmon_patch((void *)&ctxt, secmon_base, h_cfg.t210b01);
 
+	btrace_end(BT_PKG1_UNPACK);
+
 	gfx_puts("Caricati warmboot and secmon\n");
 
-	// Read package2.
-	u8 *bootConfigBuf = _read_emmc_pkg2(&ctxt);
-	if (!bootConfigBuf)
+	// Wait for package2.
+	if (!emummc_storage_read_wait())
 	{
 		_hos_crit_error("Lettura di Pkg2 fallita!");
 		goto error;
 	}
+	btrace_end(BT_PKG2_READ);
 
 	gfx_puts("Pkg2 letto\n");
 
 	// Decrypt package2 and parse KIP1 blobs in INI1 section.
+	btrace_begin(BT_PKG2_DECRYPT);
 	pkg2_hdr_t *pkg2_hdr = pkg2_decrypt(ctxt.pkg2, kb);
+	btrace_end(BT_PKG2_DECRYPT);
 	if (!pkg2_hdr)
 	{
 		_hos_crit_error("Decrittazione di Pkg2 fallita!");
@@ -939,12 +987,29 @@ int hos_launch(ini_sec_t *cfg)
 	else if (kb >= KB_FIRMWARE_VERSION_700)
 		hos_eks_save(kb); // Save EKS slot if it doesn't exist.
 
+	// Reuse a previously built package2 if nothing that affects it has changed.
+	u8 cache_key[0x20];
+	bool pkg2_cacheable = ctxt.pkg2_cache && !ctxt.stock && pkg2_cache_key(cache_key, &ctxt);
+	if (pkg2_cacheable)
+	{
+		btrace_begin(BT_PKG2_BUILD);
+		bool cached = pkg2_cache_load((void *)PKG2_LOAD_ADDR, &ctxt, cache_key);
+		btrace_end(BT_PKG2_BUILD);
+		if (cached)
+		{
+			gfx_puts("Pkg2 caricato dalla cache\n");
+			goto pkg2_loaded;
+		}
+	}
+
 	LIST_INIT(kip1_info);
+	btrace_begin(BT_KIP_PARSE);
 	if (!pkg2_parse_kips(&kip1_info, pkg2_hdr, &ctxt.new_pkg2))
 	{
 		_hos_crit_error("Parsing di INI1 fallito!");
 		goto error;
 	}
+	btrace_end(BT_KIP_PARSE);
 
 	gfx_puts("Effettuato il parsing di ini1\n");
 
@@ -1002,11 +1067,11 @@ int hos_launch(ini_sec_t *cfg)
 		pkg2_merge_kip(&kip1_info, (pkg2_kip1_t *)mki->kip1);
 
 	// Check if FS is compatible with exFAT and if 5.1.0.
-	if (!ctxt.stock && (sd_fs.fs_type == FS_EXFAT || kb == KB_FIRMWARE_VERSION_500))
+	if (!ctxt.stock && (sd_fs->fs_type == FS_EXFAT || kb == KB_FIRMWARE_VERSION_500))
 	{
 		bool exfat_compat = _get_fs_exfat_compatible(&kip1_info, &ctxt.exo_ctx.fs_is_510);
 
-		if (sd_fs.fs_type == FS_EXFAT && !exfat_compat)
+		if (sd_fs->fs_type == FS_EXFAT && !exfat_compat)
 		{
 			_hos_crit_error("La scheda SD e' exFAT e il driver installato su HOS\nsupporta solo FAT32!");
 
@@ -1018,7 +1083,9 @@ int hos_launch(ini_sec_t *cfg)
 	// Patch kip1s in memory if needed.
 	if (ctxt.kip1_patches)
 		gfx_printf("%kPatchando i kips%k\n", 0xFFFFBA00, 0xFFCCCCCC);
+	btrace_begin(BT_KIP_PATCH);
 	const char* unappliedPatch = pkg2_patch_kips(&kip1_info, ctxt.kip1_patches);
+	btrace_end(BT_KIP_PATCH);
 	if (unappliedPatch != NULL)
 	{
 		EHPRINTFARGS("Applcazione di '%s' fallita!", unappliedPatch);
@@ -1027,8 +1094,10 @@ int hos_launch(ini_sec_t *cfg)
 		if (!emmc_patch_failed)
 		{
 			gfx_puts("\nPremi POWER per continuare.\nPremi VOL per andare al menu'.\n");
+			ipl_display_init();
 			display_backlight_brightness(h_cfg.backlight, 1000);
 		}
+		gfx_con_flush();
 
 		if (emmc_patch_failed || !(btn_wait() & BTN_POWER))
 		{
@@ -1038,11 +1107,17 @@ int hos_launch(ini_sec_t *cfg)
 	}
 
 	// Rebuild and encrypt package2.
-	pkg2_build_encrypt((void *)PKG2_LOAD_ADDR, &ctxt, &kip1_info);
+	btrace_begin(BT_PKG2_BUILD);
+	pkg2_build_encrypt((void *)PKG2_LOAD_ADDR, &ctxt, &kip1_info,
+		(pkg2_cacheable && !unappliedPatch) ? cache_key : NULL);
+	btrace_end(BT_PKG2_BUILD);
 
 	gfx_puts("Ricostruito & caricato pkg2\n");
 
+pkg2_loaded:
+
 	gfx_printf("\n%kSto avviando...%k\n", 0xFF96FF00, 0xFFCCCCCC);
+	gfx_con_defer(false);
 
 	// Set initial mailbox values.
 	int bootStateDramPkg2 = 0;
@@ -1093,6 +1168,11 @@ int hos_launch(ini_sec_t *cfg)
 	if (ctxt.atmosphere && ctxt.secmon)
 		config_exosphere(&ctxt, warmboot_base, exo_new);
 
+	// Save boot trace. Nothing after this point touches storage.
+	btrace_end(BT_HOS_LAUNCH);
+	if (h_cfg.boottrace)
+		sd_save_to_file(btrace_get(), sizeof(btrace_t), "bootloader/boot_trace.bin");
+
 	// Unmount SD card and eMMC.
 	sd_end();
 	sdmmc_storage_end(&emmc_storage);
@@ -1129,7 +1209,8 @@ int hos_launch(ini_sec_t *cfg)
 	secmon_mailbox->out = 0;
 
 	// Disable display. This must be executed before secmon to provide support for all fw versions.
-	display_end();
+	if (h_cfg.display_on)
+		display_end();
 
 	// Clear EMC_SCRATCH0.
 	EMC(EMC_SCRATCH0) = 0;
@@ -1167,6 +1248,9 @@ int hos_launch(ini_sec_t *cfg)
 		bpmp_halt();
 
 error:
+	btrace_end(BT_HOS_LAUNCH);
+	gfx_con_defer(false);
+	emummc_storage_read_wait(); // Drain any package2 read still in flight.
 	sdmmc_storage_end(&emmc_storage);
 	h_cfg.aes_slots_new = false;
 	return 0;
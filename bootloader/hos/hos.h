@@ -117,6 +117,7 @@ typedef struct _launch_ctxt_t
 	u32   fss0_hosver;
 	bool  fss0_experimental;
 	bool  atmosphere;
+	bool  pkg2_cache;
 
 	exo_ctxt_t exo_ctx;
 
@@ -23,6 +23,7 @@
 #include <libs/fatfs/ff.h>
 #include <mem/heap.h>
 #include <storage/nx_sd.h>
+#include <utils/btrace.h>
 #include <utils/dirlist.h>
 
 #include <gfx_utils.h>
@@ -170,6 +171,16 @@ static int _config_debugmode(launch_ctxt_t *ctxt, const char *value)
 	return 1;
 }
 
+static int _config_pkg2_cache(launch_ctxt_t *ctxt, const char *value)
+{
+	if (*value == '1')
+	{
+		DPRINTF("Cache pkg2 attivata\n");
+		ctxt->pkg2_cache = true;
+	}
+	return 1;
+}
+
 static int _config_stock(launch_ctxt_t *ctxt, const char *value)
 {
 	if (*value == '1')
@@ -271,7 +282,11 @@ static int _config_fss(launch_ctxt_t *ctxt, const char *value)
 		}
 	}
 
-	return parse_fss(ctxt, value, NULL);
+	btrace_begin(BT_FSS_PARSE);
+	int res = parse_fss(ctxt, value, NULL);
+	btrace_end(BT_FSS_PARSE);
+
+	return res;
 }
 
 static int _config_exo_fatal_payload(launch_ctxt_t *ctxt, const char *value)
@@ -302,6 +317,7 @@ static const cfg_handler_t _config_handlers[] = {
 	{ "fss0", _config_fss },
 	{ "exofatal", _config_exo_fatal_payload},
 	{ "emummcforce", _config_emummc_forced },
+	{ "pkg2cache", _config_pkg2_cache },
 	{ "nouserexceptions", _config_dis_exo_user_exceptions },
 	{ "userpmu", _config_exo_user_pmu_access },
 	{ "usb3force", _config_exo_usb3_force },
@@ -1520,7 +1520,6 @@ DPRINTF("aggiungendo kip1 '%s' @ %08X (%08X)\n", ki->kip1->name, (u32)ki->kip1,
 	{
 		hdr->sec_size[PKG2_SEC_INI1] = ini1_size;
 		hdr->sec_off[PKG2_SEC_INI1] = 0x14080000;
-		se_aes_crypt_ctr(8, ini1, ini1_size, ini1, ini1_size, &hdr->sec_ctr[PKG2_SEC_INI1 * SE_AES_IV_SIZE]);
 	}
 	else
 	{
@@ -1531,10 +1530,9 @@ DPRINTF("aggiungendo kip1 '%s' @ %08X (%08X)\n", ki->kip1->name, (u32)ki->kip1,
 	return ini1_size;
 }
 
-void pkg2_build_encrypt(void *dst, void *hos_ctxt, link_t *kips_info)
+static u32 _pkg2_build(u8 *dst, launch_ctxt_t *ctxt, link_t *kips_info)
 {
-	u8 *pdst = (u8 *)dst;
-	launch_ctxt_t * ctxt = (launch_ctxt_t *)hos_ctxt;
+	u8 *pdst = dst;
 	u32 kernel_size = ctxt->kernel_size;
 	bool is_meso = *(u32 *)(ctxt->kernel + 4) == ATM_MESOSPHERE;
 
@@ -1577,23 +1575,32 @@ DPRINTF("%s @ %08X (%08X)\n", is_meso ? "Mesosphere": "kernel",(u32)ctxt->kernel
 		hdr->sec_off[PKG2_SEC_KERNEL] = 0x60000;
 	}
 	hdr->sec_size[PKG2_SEC_KERNEL] = kernel_size;
-	se_aes_crypt_ctr(pkg2_keyslot, pdst, kernel_size, pdst, kernel_size, &hdr->sec_ctr[PKG2_SEC_KERNEL * SE_AES_IV_SIZE]);
 	pdst += kernel_size;
-DPRINTF("kernel criptato\n");
 
 	/// Build INI1 for old Package2.
-	u32 ini1_size = 0;
 	if (!ctxt->new_pkg2)
-		ini1_size = _pkg2_ini1_build(pdst, hdr, kips_info, false);
+		pdst += _pkg2_ini1_build(pdst, hdr, kips_info, false);
+
+	return pdst - dst;
+}
+
+static void _pkg2_encrypt(u8 *dst, launch_ctxt_t *ctxt)
+{
+	pkg2_hdr_t *hdr = (pkg2_hdr_t *)(dst + 0x100);
+	u8 *pdst = dst + 0x100 + sizeof(pkg2_hdr_t);
+	u32 kernel_size = hdr->sec_size[PKG2_SEC_KERNEL];
+	u32 ini1_size = hdr->sec_size[PKG2_SEC_INI1];
+
+	se_aes_crypt_ctr(pkg2_keyslot, pdst, kernel_size, pdst, kernel_size, &hdr->sec_ctr[PKG2_SEC_KERNEL * SE_AES_IV_SIZE]);
+DPRINTF("kernel criptato\n");
+
+	if (ini1_size)
+		se_aes_crypt_ctr(8, pdst + kernel_size, ini1_size, pdst + kernel_size, ini1_size, &hdr->sec_ctr[PKG2_SEC_INI1 * SE_AES_IV_SIZE]);
 DPRINTF("INI1 criptato\n");
 
 	// Calculate SHA256 over encrypted Kernel and INI1.
-	u8 *pk2_hash_data = (u8 *)dst + 0x100 + sizeof(pkg2_hdr_t);
-	se_calc_sha256_oneshot(&hdr->sec_sha256[0x20 * PKG2_SEC_KERNEL],
-		(void *)pk2_hash_data, hdr->sec_size[PKG2_SEC_KERNEL]);
-	pk2_hash_data += hdr->sec_size[PKG2_SEC_KERNEL];
-	se_calc_sha256_oneshot(&hdr->sec_sha256[0x20 * PKG2_SEC_INI1],
-		(void *)pk2_hash_data, hdr->sec_size[PKG2_SEC_INI1]);
+	se_calc_sha256_oneshot(&hdr->sec_sha256[0x20 * PKG2_SEC_KERNEL], (void *)pdst, kernel_size);
+	se_calc_sha256_oneshot(&hdr->sec_sha256[0x20 * PKG2_SEC_INI1], (void *)(pdst + kernel_size), ini1_size);
 
 	//Encrypt header.
 	u8 key_ver = ctxt->pkg1_id->kb ? ctxt->pkg1_id->kb + 1 : 0;
@@ -1607,3 +1614,165 @@ DPRINTF("INI1 criptato\n");
 	if (pkg2_keyslot != 8)
 		se_aes_key_clear(9);
 }
+
+#define PKG2_CACHE_PATH    "bootloader/pkg2_cache.bin"
+#define PKG2_CACHE_MAGIC   0x43324B50 // "PK2C".
+#define PKG2_CACHE_VERSION 1
+#define PKG2_CACHE_DGST_MAX 64
+#define PKG2_CACHE_SZ_MAX   0x1000000 // 16MB.
+
+typedef struct _pkg2_cache_hdr_t
+{
+	u32 magic;
+	u32 version;
+	u32 size;      // Unencrypted package2 size.
+	u32 fs_is_510;
+	u8  key[SE_SHA_256_SIZE];  // Digest of all build inputs.
+	u8  hash[SE_SHA_256_SIZE]; // Digest of the cached package2.
+} pkg2_cache_hdr_t;
+
+static bool _pkg2_cache_digest(u8 *dgst, u32 *cnt, const void *src, u32 size)
+{
+	if (*cnt >= PKG2_CACHE_DGST_MAX)
+		return false;
+
+	se_calc_sha256_oneshot(dgst + *cnt * SE_SHA_256_SIZE, src, size);
+	(*cnt)++;
+
+	return true;
+}
+
+static bool _pkg2_cache_digest_stat(u8 *dgst, u32 *cnt, const char *path)
+{
+	FILINFO fno;
+	u32 stamp[3] = { 0 };
+
+	// Missing files are part of the key too.
+	if (path && !f_stat(path, &fno))
+	{
+		stamp[0] = fno.fsize;
+		stamp[1] = fno.fdate;
+		stamp[2] = fno.ftime;
+	}
+
+	return _pkg2_cache_digest(dgst, cnt, stamp, sizeof(stamp));
+}
+
+bool pkg2_cache_key(u8 *key, void *hos_ctxt)
+{
+	launch_ctxt_t *ctxt = (launch_ctxt_t *)hos_ctxt;
+	u8 *dgst = (u8 *)malloc(PKG2_CACHE_DGST_MAX * SE_SHA_256_SIZE);
+	u32 cnt = 0;
+	bool res = true;
+
+	// hekate version, since it carries the patch sets, and launch options.
+	u32 flags[] = {
+		(BL_VER_MJ << 16) | (BL_VER_MN << 8) | BL_VER_HF, ctxt->pkg1_id->kb,
+		ctxt->stock, ctxt->svcperm, ctxt->debugmode, ctxt->atmosphere, ctxt->secmon != NULL,
+		ctxt->fss0_experimental, sd_fs->fs_type
+	};
+	res &= _pkg2_cache_digest(dgst, &cnt, flags, sizeof(flags));
+
+	// Decrypted stock package2 and replacement kernel.
+	res &= _pkg2_cache_digest(dgst, &cnt, ctxt->pkg2, ctxt->pkg2_size);
+	if (ctxt->kernel)
+		res &= _pkg2_cache_digest(dgst, &cnt, ctxt->kernel, ctxt->kernel_size);
+
+	// Extra and FSS0 kips.
+	LIST_FOREACH_ENTRY(merge_kip_t, mki, &ctxt->kip1_list, link)
+		res &= _pkg2_cache_digest(dgst, &cnt, mki->kip1, _pkg2_calc_kip1_size((pkg2_kip1_t *)mki->kip1));
+
+	// Requested patches and the files they come from.
+	if (ctxt->kip1_patches)
+		res &= _pkg2_cache_digest(dgst, &cnt, ctxt->kip1_patches, strlen(ctxt->kip1_patches));
+	res &= _pkg2_cache_digest_stat(dgst, &cnt, "bootloader/patches.ini");
+	res &= _pkg2_cache_digest_stat(dgst, &cnt, "bootloader/sys/emummc.kipm");
+	if (ctxt->fss0_main_path)
+	{
+		res &= _pkg2_cache_digest(dgst, &cnt, ctxt->fss0_main_path, strlen(ctxt->fss0_main_path));
+		res &= _pkg2_cache_digest_stat(dgst, &cnt, ctxt->fss0_main_path);
+	}
+
+	if (res)
+		se_calc_sha256_oneshot(key, dgst, cnt * SE_SHA_256_SIZE);
+
+	free(dgst);
+
+	return res;
+}
+
+bool pkg2_cache_load(void *dst, void *hos_ctxt, const u8 *key)
+{
+	launch_ctxt_t *ctxt = (launch_ctxt_t *)hos_ctxt;
+	pkg2_cache_hdr_t chdr;
+	u8 hash[SE_SHA_256_SIZE];
+	FIL fp;
+	UINT br;
+	bool res = false;
+
+	if (f_open(&fp, PKG2_CACHE_PATH, FA_READ))
+		return false;
+
+	if (f_read(&fp, &chdr, sizeof(chdr), &br) || br != sizeof(chdr))
+		goto out;
+
+	if (chdr.magic != PKG2_CACHE_MAGIC || chdr.version != PKG2_CACHE_VERSION ||
+		memcmp(chdr.key, key, SE_SHA_256_SIZE) || chdr.size != f_size(&fp) - sizeof(chdr) ||
+		chdr.size > PKG2_CACHE_SZ_MAX)
+		goto out;
+
+	// Load the whole image in one sequential read and validate it.
+	if (f_read(&fp, dst, chdr.size, &br) || br != chdr.size)
+		goto out;
+
+	se_calc_sha256_oneshot(hash, dst, chdr.size);
+	if (memcmp(hash, chdr.hash, SE_SHA_256_SIZE))
+		goto out;
+
+	ctxt->exo_ctx.fs_is_510 = chdr.fs_is_510;
+	_pkg2_encrypt(dst, ctxt);
+	res = true;
+
+out:
+	f_close(&fp);
+
+	return res;
+}
+
+static void _pkg2_cache_save(u8 *dst, u32 size, launch_ctxt_t *ctxt, const u8 *key)
+{
+	pkg2_cache_hdr_t chdr;
+	FIL fp;
+	UINT bw;
+
+	chdr.magic = PKG2_CACHE_MAGIC;
+	chdr.version = PKG2_CACHE_VERSION;
+	chdr.size = size;
+	chdr.fs_is_510 = ctxt->exo_ctx.fs_is_510;
+	memcpy(chdr.key, key, SE_SHA_256_SIZE);
+	se_calc_sha256_oneshot(chdr.hash, dst, size);
+
+	if (f_open(&fp, PKG2_CACHE_PATH, FA_CREATE_ALWAYS | FA_WRITE))
+		return;
+
+	bool ok = !f_write(&fp, &chdr, sizeof(chdr), &bw) && bw == sizeof(chdr) &&
+		!f_write(&fp, dst, size, &bw) && bw == size;
+	f_close(&fp);
+
+	// Never leave a partial cache behind.
+	if (!ok)
+		f_unlink(PKG2_CACHE_PATH);
+}
+
+void pkg2_build_encrypt(void *dst, void *hos_ctxt, link_t *kips_info, const u8 *cache_key)
+{
+	launch_ctxt_t *ctxt = (launch_ctxt_t *)hos_ctxt;
+
+	u32 size = _pkg2_build((u8 *)dst, ctxt, kips_info);
+
+	// Store unencrypted layout. The encryption is redone on every boot.
+	if (cache_key)
+		_pkg2_cache_save((u8 *)dst, size, ctxt, cache_key);
+
+	_pkg2_encrypt((u8 *)dst, ctxt);
+}
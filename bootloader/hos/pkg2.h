@@ -157,6 +157,8 @@ const char* pkg2_patch_kips(link_t *info, char* patchNames);
 
 const pkg2_kernel_id_t *pkg2_identify(u8 *hash);
 pkg2_hdr_t *pkg2_decrypt(void *data, u8 kb);
-void pkg2_build_encrypt(void *dst, void *hos_ctxt, link_t *kips_info);
+void pkg2_build_encrypt(void *dst, void *hos_ctxt, link_t *kips_info, const u8 *cache_key);
+bool pkg2_cache_key(u8 *key, void *hos_ctxt);
+bool pkg2_cache_load(void *dst, void *hos_ctxt, const u8 *key);
 
 #endif
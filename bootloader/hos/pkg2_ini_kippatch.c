@@ -4,6 +4,7 @@
 #include "pkg2_ini_kippatch.h"
 #include <libs/fatfs/ff.h>
 #include <mem/heap.h>
+#include <utils/ini.h>
 
 #define KPS(x) ((u32)(x) << 29)
 
@@ -86,20 +87,20 @@ static ini_kip_sec_t *_ini_create_kip_section(link_t *dst, ini_kip_sec_t *ksec,
 
 int ini_patch_parse(link_t *dst, char *ini_path)
 {
-	FIL fp;
+	ini_file_t fp;
 	u32 lblen;
 	char lbuf[512];
 	ini_kip_sec_t *ksec = NULL;
 
 	// Open ini.
-	if (f_open(&fp, ini_path, FA_READ) != FR_OK)
+	if (ini_file_open(&fp, ini_path) != FR_OK)
 		return 0;
 
 	do
 	{
 		// Fetch one line.
 		lbuf[0] = 0;
-		f_gets(lbuf, 512, &fp);
+		ini_file_gets(lbuf, 512, &fp);
 		lblen = strlen(lbuf);
 
 		// Remove trailing newline. Depends on 'FF_USE_STRFUNC 2' that removes \r.
@@ -145,9 +146,9 @@ int ini_patch_parse(link_t *dst, char *ini_path)
 
 			list_append(&ksec->pts, &pt->link);
 		}
-	} while (!f_eof(&fp));
+	} while (!ini_file_eof(&fp));
 
-	f_close(&fp);
+	ini_file_close(&fp);
 
 	if (ksec)
 		list_append(dst, &ksec->link);
@@ -35,6 +35,8 @@
 
 extern hekate_config h_cfg;
 
+extern void ipl_display_init();
+
 enum emuMMC_Type
 {
 	emuMMC_None = 0,
@@ -430,6 +432,8 @@ void secmon_exo_check_panic()
 	if ((rpt->magic & 0xF0FFFFFF) != ATM_FATAL_MAGIC)
 		return;
 
+	ipl_display_init();
+
 	gfx_clear_grey(0x1B);
 	gfx_con_setpos(0, 0);
 
@@ -70,6 +70,7 @@ extern const volatile ipl_ver_meta_t ipl_ver;
 
 extern bool is_ipl_updated(void *buf);
 extern void reloc_patcher(u32 payload_dst, u32 payload_src, u32 payload_size);
+extern void ipl_display_init();
 
 void check_sept(ini_sec_t *cfg_sec)
 {
@@ -138,6 +139,7 @@ void check_sept(ini_sec_t *cfg_sec)
 			gfx_con.mute = false;
 			EPRINTF("Avvio di sept fallito\n""BCT principale non adeguata!\nAvvia sept con la BCT giusta almeno una volta\nper fare il caching delle chiavi.");
 			gfx_printf("\nPremi qualunque tasto...\n");
+			ipl_display_init();
 			display_backlight_brightness(h_cfg.backlight, 1000);
 			msleep(500);
 			btn_wait();
@@ -264,11 +266,14 @@ int reboot_to_sept(const u8 *tsec_fw, u32 kb, ini_sec_t *cfg_sec)
 	PMC(APBDEV_PMC_SCRATCH33) = SEPT_PRI_ADDR;
 	PMC(APBDEV_PMC_SCRATCH40) = 0x6000F208;
 
+	// The display is ended on reinit.
+	ipl_display_init();
 	hw_reinit_workaround(false, 0);
 
 	(*sept)();
 
 error:
+	ipl_display_init();
 	gfx_con.mute = false;
 	EPRINTF("Avvio di sept fallito\n");
 
@@ -247,6 +247,10 @@
 /  buffer in the filesystem object (FATFS) is used for the file data transfer. */
 
 
+#define FF_WIN_CACHE_SECTORS	0
+/* Number of sectors cached behind the disk access window. (0:Disable) */
+
+
 #define FF_FS_EXFAT		1
 /* This option switches support for exFAT filesystem. (0:Disable or 1:Enable)
 /  To enable exFAT, also LFN needs to be enabled. (FF_USE_LFN >= 1)
@@ -52,6 +52,7 @@
 #include <storage/nx_sd.h>
 #include <storage/sdmmc.h>
 #include <utils/btn.h>
+#include <utils/btrace.h>
 #include <utils/dirlist.h>
 #include <utils/list.h>
 #include <utils/util.h>
@@ -108,6 +109,23 @@ void emmcsn_path_impl(char *path, char *sub_dir, char *filename, sdmmc_storage_t
 		sdmmc_storage_end(&emmc_storage);
 }
 
+void ipl_display_init()
+{
+	if (h_cfg.display_on)
+		return;
+
+	btrace_begin(BT_DISPLAY_INIT);
+	display_init();
+
+	// Keep anything already drawn while the display was off.
+	display_activate_framebuffer_pitch();
+
+	display_backlight_pwm_init();
+	btrace_end(BT_DISPLAY_INIT);
+
+	h_cfg.display_on = true;
+}
+
 void check_power_off_from_hos()
 {
 	// Power off on AutoRCM wakeup from HOS shutdown. For modchips/dongles.
@@ -121,6 +139,8 @@ void check_power_off_from_hos()
 
 		if (h_cfg.autohosoff == 1)
 		{
+			ipl_display_init();
+
 			gfx_clear_grey(0x1B);
 			u8 *BOOTLOGO = (void *)malloc(0x4000);
 			blz_uncompress_srcdest(BOOTLOGO_BLZ, SZ_BOOTLOGO_BLZ, BOOTLOGO, SZ_BOOTLOGO);
@@ -255,6 +275,9 @@ int launch_payload(char *path, bool update)
 		if (update && is_ipl_updated(buf, path, false))
 			goto out;
 
+		// The display is handed over or ended on payload launch.
+		ipl_display_init();
+
 		sd_end();
 
 		if (size < 0x30000)
@@ -681,9 +704,11 @@ out:
 
 void nyx_load_run()
 {
+	btrace_begin(BT_NYX_LOAD);
+
 	sd_mount();
 
-	u8 *nyx = sd_file_read("bootloader/sys/nyx.bin", NULL);
+	u8 *nyx = sd_file_read_lz4c("bootloader/sys/nyx.bin", NULL);
 	if (!nyx)
 		return;
 
@@ -757,6 +782,8 @@ void nyx_load_run()
 	// Some cards (Sandisk U1), do not like a fast power cycle. Wait min 100ms.
 	sdmmc_storage_init_wait_sd();
 
+	btrace_end(BT_NYX_LOAD);
+
 	(*nyx_ptr)();
 }
 
@@ -802,6 +829,26 @@ static void _bootloader_corruption_protect()
 	}
 }
 
+static ini_sec_t *_boot_cache_sec = NULL;
+
+static void _boot_cache_check()
+{
+	// Only plain autoboot. Forced, Nyx or sept boots and VOL- for menu take the normal path.
+	if (h_cfg.errors || b_cfg.extra_cfg ||
+		(b_cfg.boot_cfg & (BOOT_CFG_FROM_LAUNCH | BOOT_CFG_FROM_ID | BOOT_CFG_TO_EMUMMC)) ||
+		((b_cfg.boot_cfg & BOOT_CFG_AUTOBOOT_EN) && b_cfg.autoboot_list) ||
+		(btn_read_vol() & BTN_VOL_DOWN))
+		return;
+
+	btrace_begin(BT_CFG_CACHE);
+	_boot_cache_sec = boot_cache_load();
+	btrace_end(BT_CFG_CACHE);
+
+	// Sept run must boot the same entry.
+	if (_boot_cache_sec && (b_cfg.boot_cfg & BOOT_CFG_AUTOBOOT_EN) && b_cfg.autoboot != h_cfg.autoboot)
+		_boot_cache_sec = NULL;
+}
+
 static void _auto_launch_firmware()
 {
 	if(b_cfg.extra_cfg & EXTRA_CFG_NYX_SEPT)
@@ -843,12 +890,41 @@ static void _auto_launch_firmware()
 	LIST_INIT(ini_sections);
 	LIST_INIT(ini_list_sections);
 
-	if (sd_mount())
+	if (_boot_cache_sec)
+	{
+		// Compiled autoboot entry. hekate_ipl.ini is unchanged since it was saved.
+		cfg_sec = _boot_cache_sec;
+		LIST_FOREACH_ENTRY(ini_kv_t, kv, &cfg_sec->kvs, link)
+		{
+			if (!strcmp("emummc_force_disable", kv->key))
+				h_cfg.emummc_force_disable = atoi(kv->val);
+			else if (!strcmp("emupath", kv->key))
+				emummc_path = kv->val;
+		}
+
+		// Save autoboot for a possible sept run.
+		if (!(b_cfg.boot_cfg & BOOT_CFG_AUTOBOOT_EN))
+		{
+			b_cfg.autoboot = h_cfg.autoboot;
+			b_cfg.autoboot_list = 0;
+		}
+
+		// Apply bootloader protection against corruption.
+		_bootloader_corruption_protect();
+
+		if (h_cfg.autohosoff && !(b_cfg.boot_cfg & BOOT_CFG_AUTOBOOT_EN))
+			check_power_off_from_hos();
+	}
+	else if (sd_mount())
 	{
 		if (f_stat("bootloader/hekate_ipl.ini", NULL))
 			create_config_entry();
 
-		if (ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false))
+		btrace_begin(BT_INI_PARSE);
+		bool ini_parsed = ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false);
+		btrace_end(BT_INI_PARSE);
+
+		if (ini_parsed)
 		{
 			u32 configEntry = 0;
 			u32 boot_entry_id = 0;
@@ -880,6 +956,8 @@ static void _auto_launch_firmware()
 								h_cfg.updater2p = atoi(kv->val);
 							else if (!strcmp("bootprotect", kv->key))
 								h_cfg.bootprotect = atoi(kv->val);
+							else if (!strcmp("boottrace", kv->key))
+								h_cfg.boottrace = atoi(kv->val);
 						}
 						boot_entry_id++;
 
@@ -934,7 +1012,11 @@ static void _auto_launch_firmware()
 				boot_entry_id = 1;
 				bootlogoCustomEntry = NULL;
 
-				if (ini_parse(&ini_list_sections, "bootloader/ini", true))
+				btrace_begin(BT_INI_PARSE);
+				bool ini_list_parsed = ini_parse(&ini_list_sections, "bootloader/ini", true);
+				btrace_end(BT_INI_PARSE);
+
+				if (ini_list_parsed)
 				{
 					LIST_FOREACH_ENTRY(ini_sec_t, ini_sec_list, &ini_list_sections, link)
 					{
@@ -1079,6 +1161,11 @@ skip_list:
 			goto wrong_emupath;
 		}
 
+		// Compile plain autoboot entries, so next boots can skip ini parsing and display init.
+		if (!_boot_cache_sec && !boot_from_id && !h_cfg.autoboot_list && !h_cfg.bootwait &&
+			!(b_cfg.boot_cfg & (BOOT_CFG_FROM_LAUNCH | BOOT_CFG_AUTOBOOT_EN)))
+			boot_cache_save(cfg_sec);
+
 		check_sept(cfg_sec);
 		hos_launch(cfg_sec);
 
@@ -1092,6 +1179,7 @@ wrong_emupath:
 		}
 
 payload_error:
+		ipl_display_init();
 		gfx_con.mute = 0;
 		gfx_printf("\nPremi qualunque tasto...\n");
 		display_backlight_brightness(h_cfg.backlight, 1000);
@@ -1100,6 +1188,7 @@ payload_error:
 	}
 
 out:
+	ipl_display_init();
 	gfx_con.mute = false;
 
 	// Clear boot reasons from binary.
@@ -1111,6 +1200,8 @@ out:
 	// L4T: Clear custom boot mode flags from PMC_SCRATCH0.
 	PMC(APBDEV_PMC_SCRATCH0) &= ~PMC_SCRATCH0_MODE_CUSTOM_ALL;
 
+	btrace_end(BT_AUTOBOOT);
+
 	nyx_load_run();
 }
 
@@ -1183,6 +1274,8 @@ static void _show_errors()
 
 	if (h_cfg.errors)
 	{
+		ipl_display_init();
+
 		gfx_clear_grey(0x1B);
 		gfx_con_setpos(0, 0);
 		display_backlight_brightness(150, 1000);
@@ -1529,6 +1622,15 @@ void ipl_main()
 	// Tegra/Horizon configuration goes to 0x80000000+, package2 goes to 0xA9800000, we place our heap in between.
 	heap_init(IPL_HEAP_START);
 
+	// IRAM can't be DMA'd, so keep the SD FatFs object in DRAM.
+	sd_fs = (FATFS *)calloc(1, sizeof(FATFS));
+
+	// Start boot trace. It lives in Nyx storage so Nyx can show it.
+	btrace_init((btrace_t *)&nyx_str->info.btrace);
+
+	// Config files are read once and shared with Nyx.
+	ini_arena_init((void *)nyx_str->ini_arena, NYX_INI_ARENA_SZ, false);
+
 #ifdef DEBUG_UART_PORT
 	uart_send(DEBUG_UART_PORT, (u8 *)"hekate: Ciao!\r\n", 16);
 	uart_wait_idle(DEBUG_UART_PORT, UART_TX_IDLE);
@@ -1541,9 +1643,12 @@ void ipl_main()
 	set_default_configuration();
 
 	// Mount SD Card.
+	btrace_begin(BT_SD_MOUNT);
 	h_cfg.errors |= !sd_mount() ? ERR_SD_BOOT_EN : 0;
+	btrace_end(BT_SD_MOUNT);
 
 	// Save sdram lp0 config.
+	btrace_begin(BT_MTC_INIT);
 	void *sdram_params =
 		hw_get_chip_id() == GP_HIDREV_MAJOR_T210 ? sdram_get_params_patched() : sdram_get_params_t210b01();
 	if (!ianos_loader("bootloader/sys/libsys_lp0.bso", DRAM_LIB, sdram_params))
@@ -1552,15 +1657,20 @@ void ipl_main()
 	// Train DRAM and switch to max frequency.
 	if (minerva_init()) //!TODO: Add Tegra210B01 support to minerva.
 		h_cfg.errors |= ERR_LIBSYS_MTC;
+	btrace_end(BT_MTC_INIT);
 
-	display_init();
+	// Check if autoboot can use the compiled boot entry.
+	_boot_cache_check();
 
-	u32 *fb = display_init_framebuffer_pitch();
-	gfx_init_ctxt(fb, 720, 1280, 720);
+	// Sanitize framebuffer area and set up the console.
+	memset((u32 *)IPL_FB_ADDRESS, 0, 0x3C0000);
+	gfx_init_ctxt((u32 *)IPL_FB_ADDRESS, 720, 1280, 720);
 
 	gfx_con_init();
 
-	display_backlight_pwm_init();
+	// On fast autoboot, the panel is only brought up if an error or user prompt needs it.
+	if (!_boot_cache_sec)
+		ipl_display_init();
 	//display_backlight_brightness(h_cfg.backlight, 1000);
 
 	// Overclock BPMP.
@@ -1579,6 +1689,7 @@ void ipl_main()
 	_show_errors();
 
 	// Load saved configuration and auto boot if enabled.
+	btrace_begin(BT_AUTOBOOT);
 	_auto_launch_firmware();
 
 	// Failed to launch Nyx, unmount SD Card.
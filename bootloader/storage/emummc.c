@@ -32,6 +32,15 @@
 extern hekate_config h_cfg;
 emummc_cfg_t emu_cfg = { 0 };
 
+static struct
+{
+	bool busy;
+	int  res;
+	u32  sector;
+	u32  num_sectors;
+	void *buf;
+} emu_async = { 0 };
+
 void emummc_load_cfg()
 {
 	emu_cfg.enabled = 0;
@@ -49,33 +58,20 @@ void emummc_load_cfg()
 	emu_cfg.nintendo_path[0] = 0;
 	emu_cfg.emummc_file_based_path[0] = 0;
 
-	LIST_INIT(ini_sections);
-	if (ini_parse(&ini_sections, "emuMMC/emummc.ini", false))
-	{
-		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_sections, link)
-		{
-			if (ini_sec->type == INI_CHOICE)
-			{
-				if (strcmp(ini_sec->name, "emummc"))
-					continue;
-
-				LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
-				{
-					if (!strcmp("enabled", kv->key))
-						emu_cfg.enabled = atoi(kv->val);
-					else if (!strcmp("sector", kv->key))
-						emu_cfg.sector = strtol(kv->val, NULL, 16);
-					else if (!strcmp("id", kv->key))
-						emu_cfg.id = strtol(kv->val, NULL, 16);
-					else if (!strcmp("path", kv->key))
-						emu_cfg.path = kv->val;
-					else if (!strcmp("nintendo_path", kv->key))
-						strcpy(emu_cfg.nintendo_path, kv->val);
-				}
-				break;
-			}
-		}
-	}
+	// Lookups are served from the config arena. Strings stay valid for the whole boot stage.
+	char *val = ini_arena_get("emuMMC/emummc.ini", "emummc", "enabled");
+	if (val)
+		emu_cfg.enabled = atoi(val);
+	val = ini_arena_get("emuMMC/emummc.ini", "emummc", "sector");
+	if (val)
+		emu_cfg.sector = strtol(val, NULL, 16);
+	val = ini_arena_get("emuMMC/emummc.ini", "emummc", "id");
+	if (val)
+		emu_cfg.id = strtol(val, NULL, 16);
+	emu_cfg.path = ini_arena_get("emuMMC/emummc.ini", "emummc", "path");
+	val = ini_arena_get("emuMMC/emummc.ini", "emummc", "nintendo_path");
+	if (val)
+		strcpy(emu_cfg.nintendo_path, val);
 }
 
 bool emummc_set_path(char *path)
@@ -228,6 +224,41 @@ int emummc_storage_read(u32 sector, u32 num_sectors, void *buf)
 	return 1;
 }
 
+int emummc_storage_read_async(u32 sector, u32 num_sectors, void *buf)
+{
+	emu_async.sector = sector;
+	emu_async.num_sectors = num_sectors;
+	emu_async.buf = buf;
+
+	// Only sysMMC has a controller of its own. emuMMC shares SDMMC1 with FatFs, so read it now.
+	if ((!emu_cfg.enabled || h_cfg.emummc_force_disable) &&
+		sdmmc_storage_submit_rw(&emmc_storage, sector, num_sectors, buf, 0))
+	{
+		emu_async.busy = true;
+		return 1;
+	}
+
+	emu_async.busy = false;
+	emu_async.res = emummc_storage_read(sector, num_sectors, buf);
+
+	return emu_async.res;
+}
+
+int emummc_storage_read_wait()
+{
+	if (!emu_async.busy)
+		return emu_async.res;
+
+	emu_async.busy = false;
+	emu_async.res = sdmmc_storage_wait_rw(&emmc_storage);
+
+	// Retry with the synchronous path, which also handles bus speed fallbacks.
+	if (!emu_async.res)
+		emu_async.res = sdmmc_storage_read(&emmc_storage, emu_async.sector, emu_async.num_sectors, emu_async.buf);
+
+	return emu_async.res;
+}
+
 int emummc_storage_write(u32 sector, u32 num_sectors, void *buf)
 {
 	FIL fp;
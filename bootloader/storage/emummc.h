@@ -55,6 +55,8 @@ int  emummc_storage_init_mmc();
 int  emummc_storage_end();
 int  emummc_storage_read(u32 sector, u32 num_sectors, void *buf);
 int  emummc_storage_write(u32 sector, u32 num_sectors, void *buf);
+int  emummc_storage_read_async(u32 sector, u32 num_sectors, void *buf);
+int  emummc_storage_read_wait();
 int  emummc_storage_set_mmc_partition(u32 partition);
 
 #endif
\ No newline at end of file
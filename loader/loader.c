@@ -21,7 +21,13 @@
 #include "payload_01.h"
 
 #include <memory_map.h>
+#ifdef LDR_COMPR_LZE
+#include <libs/compr/lze.h>
+#define payload_uncompress lze_uncompress
+#else
 #include <libs/compr/lz.h>
+#define payload_uncompress LZ_Uncompress
+#endif
 #include <soc/clock.h>
 #include <soc/t210.h>
 
@@ -92,12 +98,12 @@ void loader_main()
 	// Set source address of the first part.
 	u8 *src_addr = (void *)(IPL_RELOC_TOP - ALIGN(payload_size, 4));
 	// Uncompress first part.
-	u32 dst_pos = LZ_Uncompress((const u8 *)src_addr, (u8*)IPL_LOAD_ADDR, sizeof(payload_00));
+	u32 dst_pos = payload_uncompress((const u8 *)src_addr, (u8*)IPL_LOAD_ADDR, sizeof(payload_00));
 
 	// Set source address of the second part. Includes array alignment.
 	src_addr += (u32)payload_01 - (u32)payload_00;
 	// Uncompress second part.
-	LZ_Uncompress((const u8 *)src_addr, (u8*)IPL_LOAD_ADDR + dst_pos, sizeof(payload_01));
+	payload_uncompress((const u8 *)src_addr, (u8*)IPL_LOAD_ADDR + dst_pos, sizeof(payload_01));
 
 	// Copy over boot configuration storage.
 	memcpy((u8 *)(IPL_LOAD_ADDR + IPL_PATCHED_RELOC_SZ), &b_cfg, sizeof(boot_cfg_t));
@@ -44,6 +44,7 @@ void set_default_configuration()
 	h_cfg.autonogc = 1;
 	h_cfg.updater2p = 0;
 	h_cfg.bootprotect = 0;
+	h_cfg.boottrace = 0;
 	h_cfg.errors = 0;
 	h_cfg.eks = NULL;
 	h_cfg.sept_run = EMC(EMC_SCRATCH0) & EMC_SEPT_RUN;
@@ -65,6 +66,8 @@ void set_nyx_default_configuration()
 	n_cfg.ums_emmc_rw = 0;
 	n_cfg.jc_disable = 0;
 	n_cfg.new_powersave = 1;
+	n_cfg.profiler = 0;
+	n_cfg.emmc_bulk_wr = 0;
 }
 
 int create_config_entry()
@@ -98,6 +101,7 @@ int create_config_entry()
 		}
 	}
 
+	ini_arena_drop("bootloader/hekate_ipl.ini");
 	if (f_open(&fp, "bootloader/hekate_ipl.ini", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
 		return 1;
 	// Add config entry.
@@ -125,6 +129,9 @@ int create_config_entry()
 	f_puts("\nbootprotect=", &fp);
 	itoa(h_cfg.bootprotect, lbuf, 10);
 	f_puts(lbuf, &fp);
+	f_puts("\nboottrace=", &fp);
+	itoa(h_cfg.boottrace, lbuf, 10);
+	f_puts(lbuf, &fp);
 	f_puts("\n", &fp);
 
 	if (mainIniFound)
@@ -184,6 +191,7 @@ int create_nyx_config_entry()
 	// Make sure that bootloader folder exists.
 	f_mkdir("bootloader");
 
+	ini_arena_drop("bootloader/nyx.ini");
 	if (f_open(&fp, "bootloader/nyx.ini", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
 		return 1;
 
@@ -209,6 +217,12 @@ int create_nyx_config_entry()
 	f_puts("\nnewpowersave=", &fp);
 	itoa(n_cfg.new_powersave, lbuf, 10);
 	f_puts(lbuf, &fp);
+	f_puts("\nprofiler=", &fp);
+	itoa(n_cfg.profiler, lbuf, 10);
+	f_puts(lbuf, &fp);
+	f_puts("\nemmcbulkwr=", &fp);
+	itoa(n_cfg.emmc_bulk_wr, lbuf, 10);
+	f_puts(lbuf, &fp);
 	f_puts("\n", &fp);
 
 	f_close(&fp);
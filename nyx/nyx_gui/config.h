@@ -31,6 +31,7 @@ typedef struct _hekate_config
 	u32 autonogc;
 	u32 updater2p;
 	u32 bootprotect;
+	u32 boottrace;
 	// Global temporary config.
 	bool t210b01;
 	bool se_keygen_done;
@@ -52,6 +53,8 @@ typedef struct _nyx_config
 	u32 ums_emmc_rw;
 	u32 jc_disable;
 	u32 new_powersave;
+	u32 profiler;
+	u32 emmc_bulk_wr;
 } nyx_config;
 
 void set_default_configuration();
@@ -1212,10 +1212,13 @@ static int _restore_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_pa
 			free(clmt);
 			return 0;
 		}
+		u32 wr_timer = get_tmr_us();
 		if (!gui->raw_emummc)
 			res = !sdmmc_storage_write(storage, lba_curr, num, buf);
 		else
 			res = !sdmmc_storage_write(&sd_storage, lba_curr + sd_sector_off, num, buf);
+		gui->wr_time_us += get_tmr_us() - wr_timer;
+		gui->wr_sectors += num;
 
 		manual_system_maintenance(false);
 
@@ -1275,6 +1278,21 @@ static int _restore_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_pa
 	f_close(&fp);
 	free(clmt);
 
+	// Flush eMMC cache at partition boundaries. No-op if not enabled.
+	if (!gui->raw_emummc)
+	{
+		u32 wr_timer = get_tmr_us();
+		if (!sdmmc_storage_flush_mmc_cache(storage))
+		{
+			s_printf(gui->txt_buf, "\n#FF0000 Svuotamento cache eMMC fallito!#\n");
+			lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+			manual_system_maintenance(true);
+
+			return 0;
+		}
+		gui->wr_time_us += get_tmr_us() - wr_timer;
+	}
+
 	if (n_cfg.verification && !gui->raw_emummc)
 	{
 		// Verify restored data.
@@ -1374,6 +1392,11 @@ void restore_emmc_selected(emmcPartType_t restoreType, emmc_tool_gui_t *gui)
 		goto out;
 	}
 
+	// Bulk write mode. Enable eMMC volatile cache for the duration of the restore.
+	bool bulk_wr = n_cfg.emmc_bulk_wr && !gui->raw_emummc && sdmmc_storage_set_mmc_cache(&emmc_storage, 1);
+	gui->wr_sectors = 0;
+	gui->wr_time_us = 0;
+
 	int i = 0;
 	char sdPath[OUT_FILENAME_SZ];
 
@@ -1485,6 +1508,8 @@ void restore_emmc_selected(emmcPartType_t restoreType, emmc_tool_gui_t *gui)
 	}
 
 	timer = get_tmr_s() - timer;
+	if (bulk_wr && !sdmmc_storage_set_mmc_cache(&emmc_storage, 0))
+		res = 0;
 	sdmmc_storage_end(&emmc_storage);
 
 	if (res && n_cfg.verification && !gui->raw_emummc)
@@ -1494,6 +1519,15 @@ void restore_emmc_selected(emmcPartType_t restoreType, emmc_tool_gui_t *gui)
 	else
 		s_printf(txt_buf, "Tempo impiegato: %dm %ds.", timer / 60, timer % 60);
 
+	// Report write rate, so bulk write mode can be compared against normal restores.
+	if (gui->wr_time_us)
+	{
+		u32 rate_kib = ((u64)gui->wr_sectors * 500000) / gui->wr_time_us;
+		s_printf(txt_buf + strlen(txt_buf), "\nScrittura: %d.%02d MiB/s", rate_kib / 1024, (rate_kib % 1024) * 100 / 1024);
+		if (!gui->raw_emummc)
+			s_printf(txt_buf + strlen(txt_buf), " (cache eMMC %s).", bulk_wr ? "attiva" : "disattivata");
+	}
+
 	lv_label_set_text(gui->label_finish, txt_buf);
 
 out:
@@ -49,30 +49,18 @@ void load_emummc_cfg(emummc_cfg_t *emu_info)
 {
 	memset(emu_info, 0, sizeof(emummc_cfg_t));
 
-	// Parse emuMMC configuration.
-	LIST_INIT(ini_sections);
-	if (ini_parse(&ini_sections, "emuMMC/emummc.ini", false))
-	{
-		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_sections, link)
-		{
-			if (!strcmp(ini_sec->name, "emummc"))
-			{
-				LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
-				{
-					if (!strcmp("enabled", kv->key))
-						emu_info->enabled = atoi(kv->val);
-					else if (!strcmp("sector", kv->key))
-						emu_info->sector = strtol(kv->val, NULL, 16);
-					else if (!strcmp("id", kv->key))
-						emu_info->id = strtol(kv->val, NULL, 16);
-					else if (!strcmp("path", kv->key))
-						emu_info->path = kv->val;
-					else if (!strcmp("nintendo_path", kv->key))
-						emu_info->nintendo_path = kv->val;
-				}
-			}
-		}
-	}
+	// Parse emuMMC configuration. Lookups are served from the config arena.
+	char *val = ini_arena_get("emuMMC/emummc.ini", "emummc", "enabled");
+	if (val)
+		emu_info->enabled = atoi(val);
+	val = ini_arena_get("emuMMC/emummc.ini", "emummc", "sector");
+	if (val)
+		emu_info->sector = strtol(val, NULL, 16);
+	val = ini_arena_get("emuMMC/emummc.ini", "emummc", "id");
+	if (val)
+		emu_info->id = strtol(val, NULL, 16);
+	emu_info->path = ini_arena_get("emuMMC/emummc.ini", "emummc", "path");
+	emu_info->nintendo_path = ini_arena_get("emuMMC/emummc.ini", "emummc", "nintendo_path");
 }
 
 void save_emummc_cfg(u32 part_idx, u32 sector_start, const char *path)
@@ -82,6 +70,7 @@ void save_emummc_cfg(u32 part_idx, u32 sector_start, const char *path)
 	char lbuf[16];
 	FIL fp;
 
+	ini_arena_drop("emuMMC/emummc.ini");
 	if (f_open(&fp, "emuMMC/emummc.ini", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
 		return;
 
@@ -686,9 +675,17 @@ static int _dump_emummc_raw_part(emmc_tool_gui_t *gui, int active_part, int part
 		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, "Fatto!\n");
 
 		// Flush BIS cache, deinit, clear BIS keys slots and reinstate SBK.
-		nx_emmc_bis_end();
+		int flush_error = nx_emmc_bis_end();
 		hos_bis_keys_clear();
 
+		if (flush_error)
+		{
+			s_printf(gui->txt_buf, "#FF0000 Scrittura di USER fallita!#\nSi prega di riprovare...\n");
+			lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+
+			return 0;
+		}
+
 		s_printf(gui->txt_buf, "Scrivendo la nuova GPT... ");
 		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
 		manual_system_maintenance(true);
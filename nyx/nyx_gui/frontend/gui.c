@@ -21,6 +21,7 @@
 #include "gui_tools.h"
 #include "gui_info.h"
 #include "gui_options.h"
+#include "gui_profiler.h"
 #include <libs/lvgl/lv_themes/lv_theme_hekate.h>
 #include <libs/lvgl/lvgl.h>
 #include "../gfx/logos-gui.h"
@@ -115,6 +116,17 @@ static jc_lv_driver_t jc_drv_ctx;
 
 static gui_status_bar_ctx status_bar;
 
+typedef struct _gui_main_tabs_t
+{
+	lv_theme_t *th;
+	lv_obj_t *tab[5];
+	bool built[5];
+} gui_main_tabs_t;
+
+static gui_main_tabs_t main_tabs;
+
+gui_timing_t gui_timing;
+
 static void _nyx_disp_init()
 {
 	display_backlight_brightness(0, 1000);
@@ -557,6 +569,24 @@ static bool _jc_virt_mouse_read(lv_indev_data_t *data)
 	return false; // No buffering so no more data read.
 }
 
+static bool _fts_touch_read_profiled(lv_indev_data_t *data)
+{
+	u32 start = get_tmr_us();
+	bool res = _fts_touch_read(data);
+	gui_prof_add(GUI_PROF_TOUCH_READ, get_tmr_us() - start);
+
+	return res;
+}
+
+static bool _jc_virt_mouse_read_profiled(lv_indev_data_t *data)
+{
+	u32 start = get_tmr_us();
+	bool res = _jc_virt_mouse_read(data);
+	gui_prof_add(GUI_PROF_JC_READ, get_tmr_us() - start);
+
+	return res;
+}
+
 typedef struct _system_maintenance_tasks_t
 {
 	union
@@ -587,91 +617,6 @@ void manual_system_maintenance(bool refresh)
 		lv_refr_now();
 }
 
-lv_img_dsc_t *bmp_to_lvimg_obj(const char *path)
-{
-	u32 fsize;
-	u8 *bitmap = sd_file_read(path, &fsize);
-	if (!bitmap)
-		return NULL;
-
-	struct _bmp_data
-	{
-		u32 size;
-		u32 size_x;
-		u32 size_y;
-		u32 offset;
-	};
-
-	struct _bmp_data bmpData;
-
-	// Get values manually to avoid unaligned access.
-	bmpData.size = bitmap[2] | bitmap[3] << 8 |
-		bitmap[4] << 16 | bitmap[5] << 24;
-	bmpData.offset = bitmap[10] | bitmap[11] << 8 |
-		bitmap[12] << 16 | bitmap[13] << 24;
-	bmpData.size_x = bitmap[18] | bitmap[19] << 8 |
-		bitmap[20] << 16 | bitmap[21] << 24;
-	bmpData.size_y = bitmap[22] | bitmap[23] << 8 |
-		bitmap[24] << 16 | bitmap[25] << 24;
-	// Sanity check.
-	if (bitmap[0] == 'B' &&
-		bitmap[1] == 'M' &&
-		bitmap[28] == 32 && // Only 32 bit BMPs allowed.
-		bmpData.size <= fsize)
-	{
-		// Check if non-default Bottom-Top.
-		bool flipped = false;
-		if (bmpData.size_y & 0x80000000)
-		{
-			bmpData.size_y = ~(bmpData.size_y) + 1;
-			flipped = true;
-		}
-
-		lv_img_dsc_t *img_desc = (lv_img_dsc_t *)bitmap;
-		u32 offset_copy = ALIGN((u32)bitmap + sizeof(lv_img_dsc_t), 0x10);
-
-		img_desc->header.always_zero = 0;
-		img_desc->header.w = bmpData.size_x;
-		img_desc->header.h = bmpData.size_y;
-		img_desc->header.cf = (bitmap[28] == 32) ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
-		img_desc->data_size = bmpData.size - bmpData.offset;
-		img_desc->data = (u8 *)offset_copy;
-
-		u32 *tmp = malloc(bmpData.size);
-		u32 *tmp2 = (u32 *)offset_copy;
-
-		// Copy the unaligned data to an aligned buffer.
-		memcpy((u8 *)tmp, bitmap + bmpData.offset, img_desc->data_size);
-		u32 j = 0;
-
-		if (!flipped)
-		{
-			for (u32 y = 0; y < bmpData.size_y; y++)
-			{
-				for (u32 x = 0; x < bmpData.size_x; x++)
-					tmp2[j++] = tmp[(bmpData.size_y - 1 - y ) * bmpData.size_x + x];
-			}
-		}
-		else
-		{
-			for (u32 y = 0; y < bmpData.size_y; y++)
-			{
-				for (u32 x = 0; x < bmpData.size_x; x++)
-					tmp2[j++] = tmp[y * bmpData.size_x + x];
-			}
-		}
-
-		free(tmp);
-	}
-	else
-	{
-		free(bitmap);
-		return NULL;
-	}
-
-	return (lv_img_dsc_t *)bitmap;
-}
-
 lv_res_t nyx_generic_onoff_toggle(lv_obj_t *btn)
 {
 	lv_obj_t *label_btn = lv_obj_get_child(btn, NULL);
@@ -812,6 +757,17 @@ lv_res_t lv_win_close_action_custom(lv_obj_t * btn)
     return lv_win_close_action(btn);
 }
 
+static lv_res_t _win_close_action_cached(lv_obj_t * btn)
+{
+	// Retained windows are only hidden, so they can be shown again instantly.
+	lv_obj_t *win = lv_win_get_from_btn(btn);
+	lv_obj_set_hidden(win, true);
+
+	close_btn = NULL;
+
+	return LV_RES_OK;
+}
+
 lv_obj_t *nyx_create_standard_window(const char *win_title)
 {
 	static lv_style_t win_bg_style;
@@ -827,6 +783,33 @@ lv_obj_t *nyx_create_standard_window(const char *win_title)
 
 	close_btn = lv_win_add_btn(win, NULL, SYMBOL_CLOSE" Chiudi", lv_win_close_action_custom);
 
+	gui_timing.win_open_start = get_tmr_us();
+
+	return win;
+}
+
+bool nyx_show_cached_window(gui_win_cache_t *cache)
+{
+	if (!cache->win)
+		return false;
+
+	gui_timing.win_open_start = get_tmr_us();
+
+	// Re-add it to the screen so it's brought to the foreground.
+	lv_obj_set_parent(cache->win, lv_scr_act());
+	lv_obj_set_hidden(cache->win, false);
+	close_btn = cache->close_btn;
+
+	return true;
+}
+
+lv_obj_t *nyx_create_cached_window(const char *win_title, gui_win_cache_t *cache)
+{
+	lv_obj_t *win = nyx_create_window_custom_close_btn(win_title, _win_close_action_cached);
+
+	cache->win = win;
+	cache->close_btn = close_btn;
+
 	return win;
 }
 
@@ -845,6 +828,8 @@ lv_obj_t *nyx_create_window_custom_close_btn(const char *win_title, lv_action_t
 
 	close_btn = lv_win_add_btn(win, NULL, SYMBOL_CLOSE" Chiudi", rel_action);
 
+	gui_timing.win_open_start = get_tmr_us();
+
 	return win;
 }
 
@@ -1291,6 +1276,13 @@ static void _update_status_bar(void *params)
 	free(label);
 }
 
+static void _update_status_bar_profiled(void *params)
+{
+	u32 start = get_tmr_us();
+	_update_status_bar(params);
+	gui_prof_add(GUI_PROF_STATUS_BAR, get_tmr_us() - start);
+}
+
 static lv_res_t _create_mbox_payloads(lv_obj_t *btn)
 {
 	lv_obj_t *dark_bg = lv_obj_create(lv_scr_act(), NULL);
@@ -2018,8 +2010,44 @@ void nyx_check_ini_changes()
 	}
 }
 
+static void _create_main_tab(u32 tab_idx)
+{
+	if (main_tabs.built[tab_idx])
+		return;
+
+	u32 start = get_tmr_us();
+
+	lv_theme_t *th = main_tabs.th;
+	lv_obj_t *parent = main_tabs.tab[tab_idx];
+
+	switch (tab_idx)
+	{
+	case 0:
+		_create_tab_about(th, parent);
+		break;
+	case 1:
+		_create_tab_home(th, parent);
+		break;
+	case 2:
+		create_tab_tools(th, parent);
+		break;
+	case 3:
+		create_tab_info(th, parent);
+		break;
+	case 4:
+		create_tab_options(th, parent);
+		break;
+	}
+
+	main_tabs.built[tab_idx] = true;
+	gui_timing.tab_build_us[tab_idx] = get_tmr_us() - start;
+}
+
 static lv_res_t _show_hide_save_button(lv_obj_t *tv, uint16_t tab_idx)
 {
+	// Tabs are built on first use.
+	_create_main_tab(tab_idx);
+
 	if (tab_idx == 4) // Options.
 	{
 		lv_obj_set_opa_scale(status_bar.mid, LV_OPA_COVER);
@@ -2163,11 +2191,15 @@ static void _nyx_main_menu(lv_theme_t * th)
 
 	lv_obj_t *tab_options = lv_tabview_add_tab(tv, SYMBOL_SETTINGS" Opzioni");
 
-	_create_tab_about(th, tab_about);
-	_create_tab_home(th, tab_home);
-	create_tab_tools(th, tab_tools);
-	create_tab_info(th, tab_info);
-	create_tab_options(th, tab_options);
+	// Only build the Home tab now. The rest are built when first selected.
+	memset(&main_tabs, 0, sizeof(gui_main_tabs_t));
+	main_tabs.th = th;
+	main_tabs.tab[0] = tab_about;
+	main_tabs.tab[1] = tab_home;
+	main_tabs.tab[2] = tab_tools;
+	main_tabs.tab[3] = tab_info;
+	main_tabs.tab[4] = tab_options;
+	_create_main_tab(1);
 
 	lv_tabview_set_tab_act(tv, 1, false);
 
@@ -2178,11 +2210,15 @@ static void _nyx_main_menu(lv_theme_t * th)
 	system_tasks.task.dram_periodic_comp = lv_task_create(minerva_periodic_training, EMC_PERIODIC_TRAIN_MS, LV_TASK_PRIO_HIGHEST, NULL);
 	lv_task_ready(system_tasks.task.dram_periodic_comp);
 
-	system_tasks.task.status_bar = lv_task_create(_update_status_bar, 5000, LV_TASK_PRIO_LOW, NULL);
+	system_tasks.task.status_bar = lv_task_create(gui_prof_enabled() ? _update_status_bar_profiled : _update_status_bar,
+		5000, LV_TASK_PRIO_LOW, NULL);
 	lv_task_ready(system_tasks.task.status_bar);
 
 	lv_task_create(_check_sd_card_removed, 2000, LV_TASK_PRIO_LOWEST, NULL);
 
+	// Create profiler overlay if enabled.
+	gui_prof_create_overlay();
+
 	// Create top level global line separators.
 	lv_obj_t *line = lv_cont_create(lv_layer_top(), NULL);
 
@@ -2243,6 +2279,32 @@ static void _nyx_main_menu(lv_theme_t * th)
 	}
 }
 
+static void _gui_refr_monitor(uint32_t time_ms, uint32_t px_num)
+{
+	u32 now = get_tmr_us();
+
+	// First flushed frame of the main menu.
+	if (!gui_timing.interactive_us)
+		gui_timing.interactive_us = now - gui_timing.start_us;
+
+	// First flushed frame of a newly opened window.
+	if (gui_timing.win_open_start)
+	{
+		gui_timing.win_open_us = now - gui_timing.win_open_start;
+		gui_timing.win_open_start = 0;
+	}
+
+	if (gui_prof_enabled())
+	{
+		static u32 last_refr_us = 0;
+
+		gui_prof_add(GUI_PROF_REFRESH, time_ms * 1000);
+		if (last_refr_us)
+			gui_prof_add(GUI_PROF_FRAME, now - last_refr_us);
+		last_refr_us = now;
+	}
+}
+
 static void _nyx_gui_loop_powersave_ram()
 {
 	// Saves 280 mW.
@@ -2270,6 +2332,9 @@ static void _nyx_gui_loop_powersave_cpu()
 void nyx_load_and_run()
 {
 	memset(&system_tasks, 0, sizeof(system_maintenance_tasks_t));
+	memset(&gui_timing, 0, sizeof(gui_timing_t));
+	gui_timing.start_us = get_tmr_us();
+	gui_prof_init(n_cfg.profiler);
 
 	lv_init();
 	gfx_con.fillbg = 1;
@@ -2279,6 +2344,7 @@ void nyx_load_and_run()
 	lv_disp_drv_init(&disp_drv);
 	disp_drv.disp_flush = _disp_fb_flush;
 	lv_disp_drv_register(&disp_drv);
+	lv_refr_set_monitor_cb(_gui_refr_monitor);
 
 	// Initialize Joy-Con.
 	if (!n_cfg.jc_disable)
@@ -2289,7 +2355,7 @@ void nyx_load_and_run()
 	lv_indev_drv_t indev_drv_jc;
 	lv_indev_drv_init(&indev_drv_jc);
 	indev_drv_jc.type = LV_INDEV_TYPE_POINTER;
-	indev_drv_jc.read = _jc_virt_mouse_read;
+	indev_drv_jc.read = gui_prof_enabled() ? _jc_virt_mouse_read_profiled : _jc_virt_mouse_read;
 	memset(&jc_drv_ctx, 0, sizeof(jc_lv_driver_t));
 	jc_drv_ctx.indev = lv_indev_drv_register(&indev_drv_jc);
 	close_btn = NULL;
@@ -2299,7 +2365,7 @@ void nyx_load_and_run()
 	lv_indev_drv_t indev_drv_touch;
 	lv_indev_drv_init(&indev_drv_touch);
 	indev_drv_touch.type = LV_INDEV_TYPE_POINTER;
-	indev_drv_touch.read = _fts_touch_read;
+	indev_drv_touch.read = gui_prof_enabled() ? _fts_touch_read_profiled : _fts_touch_read;
 	lv_indev_drv_register(&indev_drv_touch);
 	touchpad.touch = false;
 
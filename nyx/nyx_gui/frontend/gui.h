@@ -32,8 +32,27 @@ typedef struct _emmc_tool_gui_t
 	char *txt_buf;
  	char *base_path;
 	bool raw_emummc;
+	u32 wr_sectors;
+	u64 wr_time_us;
 } emmc_tool_gui_t;
 
+typedef struct _gui_win_cache_t
+{
+	lv_obj_t *win;
+	lv_obj_t *close_btn;
+} gui_win_cache_t;
+
+typedef struct _gui_timing_t
+{
+	u32 start_us;        // Nyx GUI init start.
+	u32 interactive_us;  // Time until the first main menu frame was flushed.
+	u32 tab_build_us[5]; // Time spent building each main tab.
+	u32 win_open_start;
+	u32 win_open_us;     // Time until the first frame of the last opened window was flushed.
+} gui_timing_t;
+
+extern gui_timing_t gui_timing;
+
 extern lv_style_t hint_small_style;
 extern lv_style_t hint_small_style_white;
 extern lv_style_t monospace_text;
@@ -63,6 +82,8 @@ bool nyx_emmc_check_battery_enough();
 void nyx_window_toggle_buttons(lv_obj_t *win, bool disable);
 lv_obj_t *nyx_create_standard_window(const char *win_title);
 lv_obj_t *nyx_create_window_custom_close_btn(const char *win_title, lv_action_t rel_action);
+bool nyx_show_cached_window(gui_win_cache_t *cache);
+lv_obj_t *nyx_create_cached_window(const char *win_title, gui_win_cache_t *cache);
 void nyx_create_onoff_button(lv_theme_t *th, lv_obj_t *parent, lv_obj_t *btn, const char *btn_name, lv_action_t action, bool transparent);
 lv_res_t nyx_generic_onoff_toggle(lv_obj_t *btn);
 void manual_system_maintenance(bool refresh);
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018-2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gui.h"
+#include <libs/fatfs/ff.h>
+#include <mem/heap.h>
+#include <utils/types.h>
+
+#define BMP_DECODE_ROWS 64
+
+static void _bmp_flip_rows(u32 *data, u32 width, u32 rows)
+{
+	u32 *top = data;
+	u32 *bottom = data + (rows - 1) * width;
+
+	// Swap rows in place.
+	while (top < bottom)
+	{
+		for (u32 x = 0; x < width; x++)
+		{
+			u32 tmp = top[x];
+			top[x] = bottom[x];
+			bottom[x] = tmp;
+		}
+
+		top += width;
+		bottom -= width;
+	}
+}
+
+lv_img_dsc_t *bmp_to_lvimg_obj(const char *path)
+{
+	FIL fp;
+	u8 bitmap[0x20];
+
+	if (f_open(&fp, path, FA_READ) != FR_OK)
+		return NULL;
+
+	u32 fsize = f_size(&fp);
+	if (f_read(&fp, bitmap, sizeof(bitmap), NULL) != FR_OK)
+		goto out_close;
+
+	struct _bmp_data
+	{
+		u32 size;
+		u32 size_x;
+		u32 size_y;
+		u32 offset;
+	};
+
+	struct _bmp_data bmpData;
+
+	// Get values manually to avoid unaligned access.
+	bmpData.size = bitmap[2] | bitmap[3] << 8 |
+		bitmap[4] << 16 | bitmap[5] << 24;
+	bmpData.offset = bitmap[10] | bitmap[11] << 8 |
+		bitmap[12] << 16 | bitmap[13] << 24;
+	bmpData.size_x = bitmap[18] | bitmap[19] << 8 |
+		bitmap[20] << 16 | bitmap[21] << 24;
+	bmpData.size_y = bitmap[22] | bitmap[23] << 8 |
+		bitmap[24] << 16 | bitmap[25] << 24;
+
+	// Check if non-default Bottom-Top.
+	bool flipped = false;
+	if (bmpData.size_y & 0x80000000)
+	{
+		bmpData.size_y = ~(bmpData.size_y) + 1;
+		flipped = true;
+	}
+
+	// Sanity check. Dimensions are bounded to the screen so the sizes below can't wrap.
+	if (bitmap[0] != 'B' ||
+		bitmap[1] != 'M' ||
+		bitmap[28] != 32 || // Only 32 bit BMPs allowed.
+		!bmpData.size_x || bmpData.size_x > LV_HOR_RES ||
+		!bmpData.size_y || bmpData.size_y > LV_VER_RES ||
+		bmpData.size > fsize ||
+		bmpData.offset > fsize ||
+		(u64)bmpData.size_x * bmpData.size_y * sizeof(u32) > fsize - bmpData.offset)
+		goto out_close;
+
+	u32 row_size = bmpData.size_x * sizeof(u32);
+	u32 data_size = row_size * bmpData.size_y;
+
+	u32 offset_copy = ALIGN(sizeof(lv_img_dsc_t), 0x10);
+	lv_img_dsc_t *img_desc = (lv_img_dsc_t *)malloc(offset_copy + data_size);
+	if (!img_desc)
+		goto out_close;
+	u32 *data = (u32 *)((u8 *)img_desc + offset_copy);
+
+	if (f_lseek(&fp, bmpData.offset) != FR_OK)
+		goto out_free;
+
+	// Stream the pixel data straight to its final place.
+	if (flipped)
+	{
+		if (f_read(&fp, data, data_size, NULL) != FR_OK)
+			goto out_free;
+	}
+	else
+	{
+		// Bottom-Top. Read chunks of rows into their mirrored position and flip them there.
+		for (u32 y = 0; y < bmpData.size_y; y += BMP_DECODE_ROWS)
+		{
+			u32 rows = MIN(BMP_DECODE_ROWS, bmpData.size_y - y);
+			u32 *rows_data = data + (bmpData.size_y - y - rows) * bmpData.size_x;
+
+			if (f_read(&fp, rows_data, rows * row_size, NULL) != FR_OK)
+				goto out_free;
+
+			_bmp_flip_rows(rows_data, bmpData.size_x, rows);
+		}
+	}
+
+	f_close(&fp);
+
+	img_desc->header.always_zero = 0;
+	img_desc->header.w = bmpData.size_x;
+	img_desc->header.h = bmpData.size_y;
+	img_desc->header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+	img_desc->data_size = data_size;
+	img_desc->data = (u8 *)data;
+
+	return img_desc;
+
+out_free:
+	free(img_desc);
+out_close:
+	f_close(&fp);
+
+	return NULL;
+}
@@ -36,6 +36,7 @@
 #include <power/max77812.h>
 #include <sec/se.h>
 #include <sec/tsec.h>
+#include <soc/bpmp.h>
 #include <soc/fuse.h>
 #include <soc/kfuse.h>
 #include <soc/i2c.h>
@@ -45,6 +46,7 @@
 #include <storage/nx_sd.h>
 #include <storage/sdmmc.h>
 #include <utils/btn.h>
+#include <utils/btrace.h>
 #include <utils/sprintf.h>
 #include <utils/util.h>
 
@@ -53,6 +55,7 @@
 extern hekate_config h_cfg;
 extern volatile boot_cfg_t *b_cfg;
 extern volatile nyx_storage_t *nyx_str;
+extern bpmp_freq_t bpmp_clock_set;
 
 extern char *emmcsn_path_impl(char *path, char *sub_dir, char *filename, sdmmc_storage_t *storage);
 
@@ -539,9 +542,14 @@ out:
 	return LV_RES_OK;
 }
 
+static gui_win_cache_t fuses_info_win;
 static lv_res_t _create_window_fuses_info_status(lv_obj_t *btn)
 {
-	lv_obj_t *win = nyx_create_standard_window(SYMBOL_CHIP" Info Fuse HW & In Cache");
+	// Fuses and HW info never change, so reuse the window if already built.
+	if (nyx_show_cached_window(&fuses_info_win))
+		return LV_RES_OK;
+
+	lv_obj_t *win = nyx_create_cached_window(SYMBOL_CHIP" Info Fuse HW & In Cache", &fuses_info_win);
 	lv_win_add_btn(win, NULL, SYMBOL_DOWNLOAD" Salva fuse", _fuse_dump_window_action);
 	lv_win_add_btn(win, NULL, SYMBOL_INFO" Info CAL0", _create_mbox_cal0);
 
@@ -1048,9 +1056,13 @@ static void _ipatch_process(u32 offset, u32 value)
 	strcat(ipatches_txt, "\n");
 }
 
+static gui_win_cache_t bootrom_info_win;
 static lv_res_t _create_window_bootrom_info_status(lv_obj_t *btn)
 {
-	lv_obj_t *win = nyx_create_standard_window(SYMBOL_CHIP" Info Bootrom");
+	if (nyx_show_cached_window(&bootrom_info_win))
+		return LV_RES_OK;
+
+	lv_obj_t *win = nyx_create_cached_window(SYMBOL_CHIP" Info Bootrom", &bootrom_info_win);
 	lv_win_add_btn(win, NULL, SYMBOL_DOWNLOAD" Salva Bootrom", _bootrom_dump_window_action);
 
 	lv_obj_t *desc = lv_cont_create(win, NULL);
@@ -1224,6 +1236,109 @@ out:
 	return LV_RES_OK;
 }
 
+#define BENCH_LAT_BUCKETS  256
+#define BENCH_TIMELINE_MAX 256
+#define BENCH_MIXED_OPS    4096
+#define BENCH_MAINT_ITERS  1024
+
+typedef struct _bench_lat_t
+{
+	u32 hist[BENCH_LAT_BUCKETS];
+	u32 count;
+	u32 max;
+} bench_lat_t;
+
+static void _bench_lat_add(bench_lat_t *lat, u32 us)
+{
+	// Log-linear buckets. 8 sub-buckets per power of 2 keep the error under 12.5%.
+	u32 bucket = us;
+	if (us >= 8)
+	{
+		u32 msb = 31 - __builtin_clz(us);
+		bucket = (msb - 2) * 8 + ((us >> (msb - 3)) & 7);
+	}
+
+	lat->hist[bucket]++;
+	lat->count++;
+	if (us > lat->max)
+		lat->max = us;
+}
+
+static u32 _bench_lat_percentile(bench_lat_t *lat, u32 pct)
+{
+	if (!lat->count)
+		return 0;
+
+	u32 target = ((u64)lat->count * pct + 99) / 100;
+	u32 acc = 0;
+	for (u32 bucket = 0; bucket < BENCH_LAT_BUCKETS; bucket++)
+	{
+		acc += lat->hist[bucket];
+		if (acc < target)
+			continue;
+
+		// Report the upper bound of the bucket.
+		if (bucket < 8)
+			return bucket;
+
+		u32 shift = bucket / 8 - 1;
+		u32 upper = ((8 + (bucket % 8)) << shift) + (1 << shift) - 1;
+
+		return MIN(upper, lat->max);
+	}
+
+	return lat->max;
+}
+
+/*
+ * BPMP cycles of the cache maintenance done for one read transfer of size bytes.
+ * Size 0 measures the old clean and invalidate of all ways, before and after the transfer.
+ */
+static u32 _bench_maint_cycles(u32 size)
+{
+	static const u32 bpmp_mhz[BPMP_CLK_MAX] = { 408, 544, 576, 589 };
+	u8 *buf = (u8 *)MIXD_BUF_ALIGNED;
+	u32 dirty_size = size ? size : 512;
+
+	// Dirty the buffer before each transfer, like a FatFs window update. Its own cost is subtracted.
+	u32 timer_base = get_tmr_us();
+	for (u32 i = 0; i < BENCH_MAINT_ITERS; i++)
+		memset(buf, i, dirty_size);
+	timer_base = get_tmr_us() - timer_base;
+
+	u32 timer = get_tmr_us();
+	for (u32 i = 0; i < BENCH_MAINT_ITERS; i++)
+	{
+		memset(buf, i, dirty_size);
+		if (size)
+		{
+			bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, buf, size);
+			bpmp_mmu_maintenance_range(BPMP_MMU_MAINT_CLEAN_INVALID_PHY, buf, size);
+		}
+		else
+		{
+			bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+			bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+		}
+	}
+	timer = get_tmr_us() - timer;
+	timer = timer > timer_base ? timer - timer_base : 0;
+
+	bpmp_clk_rate_get();
+
+	return ((u64)timer * bpmp_mhz[bpmp_clock_set]) / BENCH_MAINT_ITERS;
+}
+
+static void _bench_csv_add(char *csv, const char *test, u32 sector, u32 kib_s, u32 iops, bench_lat_t *lat)
+{
+	s_printf(csv + strlen(csv), "%s,%08X,%d,%d,", test, sector, kib_s, iops);
+	if (lat)
+		s_printf(csv + strlen(csv), "%d,%d,%d\n",
+			_bench_lat_percentile(lat, 50), _bench_lat_percentile(lat, 99), lat->max);
+	else
+		s_printf(csv + strlen(csv), ",,\n");
+}
+
 static lv_res_t _create_mbox_benchmark(bool sd_bench)
 {
 	sdmmc_storage_t *storage;
@@ -1239,7 +1354,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 
 	char *txt_buf = (char *)malloc(0x4000);
 
-	s_printf(txt_buf, "#FF8000 %s Benchmark#\n[Letture grezze] Annulla: VOL- & VOL+",
+	s_printf(txt_buf, "#FF8000 %s Benchmark#\n[Letture/scritture grezze] Annulla: VOL- & VOL+",
 		sd_bench ? "Scheda SD" : "eMMC");
 
 	lv_mbox_set_text(mbox, txt_buf);
@@ -1289,10 +1404,15 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 	{
 		int error = 0;
 		u32 iters = 3;
+		u32 maint_cycles[3] = { 0 };
 		u32 offset_chunk_start = ALIGN_DOWN(storage->sec_cnt / 3, 0x8000); // Align to 16MB.
 		if (storage->sec_cnt < 0xC00000)
 			iters -= 2; // 4GB card.
 
+		char *csv_buf = (char *)malloc(0x4000);
+		s_printf(csv_buf, "# %s, manfid %02X, serial %08X\ntest,sector,kib_s,iops,p50_us,p99_us,max_us\n",
+			sd_bench ? "SD" : "eMMC", storage->cid.manfid, storage->cid.serial);
+
 		for (u32 iter_curr = 0; iter_curr < iters; iter_curr++)
 		{
 			u32 pct = 0;
@@ -1303,6 +1423,10 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			u32 sector_num = 0x8000;       // 16MB chunks.
 			u32 data_remaining = 0x200000; // 1GB.
 
+			// Skip regions that don't fit in the storage.
+			if (sector + data_remaining > storage->sec_cnt)
+				break;
+
 			s_printf(txt_buf + strlen(txt_buf), "#C7EA46 %d/3# - Offset settore #C7EA46 %08X#:\n", iter_curr + 1, sector);
 
 			while (data_remaining)
@@ -1337,6 +1461,8 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			s_printf(txt_buf + strlen(txt_buf),
 				" Sequenziali 16MiB - Tasso: #C7EA46 %3d.%02d MiB/s#\n",
 				rate_1k / 1000, (rate_1k % 1000) / 10);
+			_bench_csv_add(csv_buf, "seq_read_16m", sector, ((u64)0x200000 * 500000) / timer,
+				((u64)64 * 1000000) / timer, NULL);
 			lv_label_set_text(lbl_status, txt_buf);
 			lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
 			lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
@@ -1382,6 +1508,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			s_printf(txt_buf + strlen(txt_buf),
 				" Sequenziali  4KiB - Tasso: #C7EA46 %3d.%02d MiB/s#, IOPS: #C7EA46 %4d#\n",
 				rate_1k / 1000, (rate_1k % 1000) / 10, iops_1k);
+			_bench_csv_add(csv_buf, "seq_read_4k", sector, ((u64)0x100000 * 500000) / timer, iops_1k, NULL);
 			lv_label_set_text(lbl_status, txt_buf);
 			lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
 			lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
@@ -1406,6 +1533,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			prevPct = 200;
 			timer = 0;
 			data_remaining = 0x100000; // 512MB.
+			bench_lat_t *lat = (bench_lat_t *)calloc(1, sizeof(bench_lat_t));
 
 			while (data_remaining)
 			{
@@ -1413,6 +1541,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 				error = !sdmmc_storage_read(storage, sector + random_offsets[lba_idx], sector_num, (u8 *)MIXD_BUF_ALIGNED);
 				time_taken = get_tmr_us() - time_taken;
 				timer += time_taken;
+				_bench_lat_add(lat, time_taken);
 
 				manual_system_maintenance(false);
 				data_remaining -= sector_num;
@@ -1433,6 +1562,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 				if (error)
 				{
 					free(random_offsets);
+					free(lat);
 					goto error;
 				}
 			}
@@ -1442,27 +1572,281 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			rate_1k = ((u64)512 * 1000 * 1000 * 1000) / timer;
 			iops_1k = ((u64)512 * 1024 * 1000 * 1000 * 1000) / (4096 / 1024) / timer / 1000;
 			s_printf(txt_buf + strlen(txt_buf),
-				" Random      4KiB - Tasso: #C7EA46 %3d.%02d MiB/s#, IOPS: #C7EA46 %4d#\n",
-				rate_1k / 1000, (rate_1k % 1000) / 10, iops_1k);
-			if (iter_curr == iters - 1)
-				txt_buf[strlen(txt_buf) - 1] = 0; // Cut off last line change.			
+				" Random      4KiB - Tasso: #C7EA46 %3d.%02d MiB/s#, IOPS: #C7EA46 %4d#\n"
+				" Latenza          - p50/p99/max: #C7EA46 %d/%d/%d# us\n",
+				rate_1k / 1000, (rate_1k % 1000) / 10, iops_1k,
+				_bench_lat_percentile(lat, 50), _bench_lat_percentile(lat, 99), lat->max);
+			_bench_csv_add(csv_buf, "rnd_read_4k", sector, ((u64)0x100000 * 500000) / timer, iops_1k, lat);
 			lv_label_set_text(lbl_status, txt_buf);
 			lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
 			lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
 			manual_system_maintenance(true);
 			free(random_offsets);
+			free(lat);
 		}
 
-error:
+		// Cache maintenance cost per small transfer. Single sector FatFs I/O is dominated by it.
+		maint_cycles[0] = _bench_maint_cycles(0);
+		maint_cycles[1] = _bench_maint_cycles(512);
+		maint_cycles[2] = _bench_maint_cycles(4096);
+		s_printf(txt_buf + strlen(txt_buf),
+			" Cache BPMP - Cicli per lettura: tutte le vie #C7EA46 %d#, 512B #C7EA46 %d#, 4KiB #C7EA46 %d#\n",
+			maint_cycles[0], maint_cycles[1], maint_cycles[2]);
+		lv_label_set_text(lbl_status, txt_buf);
+		lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+		lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+		manual_system_maintenance(true);
+
+		// Write tests need the whole 1GB region inside the storage.
+		if (offset_chunk_start + 0x200000 > storage->sec_cnt)
+		{
+			s_printf(txt_buf + strlen(txt_buf), "#FFDD00 Test di scrittura saltati, memoria troppo piccola!#\n");
+			goto skip_wr;
+		}
+
+		// Write tests rewrite live data, so ask first.
+		u32 txt_len = strlen(txt_buf);
+		s_printf(txt_buf + txt_len,
+			"\n#FF8000 Avviso: I test di scrittura scrivono sulla memoria di archiviazione!#\n"
+			"I dati vengono letti e riscritti uguali, ma un errore puo' corromperli.\n\n"
+			"Premi #FF8000 POWER# per Continuare.\nPremi #FF8000 VOL# per saltarli.");
+		lv_label_set_text(lbl_status, txt_buf);
+		lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+		lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+		manual_system_maintenance(true);
+
+		bool write_confirmed = btn_wait() & BTN_POWER;
+		txt_buf[txt_len] = 0;
+		if (!write_confirmed)
+		{
+			s_printf(txt_buf + strlen(txt_buf), "#FFDD00 Test di scrittura saltati!#\n");
+			goto skip_wr;
+		}
+
+		// Write tests. Each region is backed up first and written back as is, so they're non-destructive.
+		s_printf(txt_buf + strlen(txt_buf), "#C7EA46 Scrittura# - Offset settore #C7EA46 %08X#:\n", offset_chunk_start);
+		lv_label_set_text(lbl_status, txt_buf);
+		lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+		lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+		manual_system_maintenance(true);
+
+		// Sequential 4MB writes with a per second timeline. A drop in the timeline shows SLC cache exhaustion.
+		u32 *timeline = (u32 *)malloc(BENCH_TIMELINE_MAX * sizeof(u32));
+		u32 timeline_cnt = 0;
+		u32 pct = 0;
+		u32 prevPct = 200;
+		u32 timer = 0;
+		u32 lba_curr = 0;
+		u32 sample_timer = 0;
+		u32 sample_sectors = 0;
+		u32 sector_num = 0x2000;       // 4MB chunks.
+		u32 data_remaining = 0x200000; // 1GB.
+
+		while (data_remaining)
+		{
+			error = !sdmmc_storage_read(storage, offset_chunk_start + lba_curr, sector_num, (u8 *)MIXD_BUF_ALIGNED);
+			if (!error)
+			{
+				u32 time_taken = get_tmr_us();
+				error = !sdmmc_storage_write(storage, offset_chunk_start + lba_curr, sector_num, (u8 *)MIXD_BUF_ALIGNED);
+				time_taken = get_tmr_us() - time_taken;
+				timer += time_taken;
+
+				// Sample throughput for every second of write time.
+				sample_timer += time_taken;
+				sample_sectors += sector_num;
+				if (sample_timer >= 1000000 && timeline_cnt < BENCH_TIMELINE_MAX)
+				{
+					timeline[timeline_cnt++] = ((u64)sample_sectors * 500000) / sample_timer;
+					sample_timer = 0;
+					sample_sectors = 0;
+				}
+			}
+
+			manual_system_maintenance(false);
+			data_remaining -= sector_num;
+			lba_curr += sector_num;
+
+			pct = (lba_curr * 100) / 0x200000;
+			if (pct != prevPct)
+			{
+				lv_bar_set_value(bar, pct);
+				manual_system_maintenance(true);
+
+				prevPct = pct;
+
+				if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+					error = -1;
+			}
+
+			if (error)
+			{
+				free(timeline);
+				goto error;
+			}
+		}
+		lv_bar_set_value(bar, 100);
+
+		u32 kib_min = 0xFFFFFFFF;
+		u32 kib_max = 0;
+		for (u32 i = 0; i < timeline_cnt; i++)
+		{
+			kib_min = MIN(kib_min, timeline[i]);
+			kib_max = MAX(kib_max, timeline[i]);
+		}
+		if (!timeline_cnt)
+			kib_min = 0;
+
+		u32 rate_1k = ((u64)1024 * 1000 * 1000 * 1000) / timer;
+		s_printf(txt_buf + strlen(txt_buf),
+			" Sequenziali  4MiB - Tasso: #C7EA46 %3d.%02d MiB/s#, Max/Min: #C7EA46 %d#/#C7EA46 %d# MiB/s\n",
+			rate_1k / 1000, (rate_1k % 1000) / 10, kib_max / 1024, kib_min / 1024);
+		_bench_csv_add(csv_buf, "seq_write_4m", offset_chunk_start, ((u64)0x200000 * 500000) / timer,
+			((u64)256 * 1000000) / timer, NULL);
+		lv_label_set_text(lbl_status, txt_buf);
+		lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+		lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+		manual_system_maintenance(true);
+
+		// Random 4KB writes and mixed read/write ratios on a backed up set of 4KB aligned offsets.
+		sdmmc_packed_wr_t *wr = (sdmmc_packed_wr_t *)malloc(sizeof(sdmmc_packed_wr_t) * BENCH_MIXED_OPS);
+		u32 *random_ops = (u32 *)malloc(BENCH_MIXED_OPS * sizeof(u32));
+		bench_lat_t *lat = (bench_lat_t *)calloc(1, sizeof(bench_lat_t));
+		u32 random_numbers[4];
+		for (u32 i = 0; i < BENCH_MIXED_OPS; i += 4)
+		{
+			// Generate new random numbers.
+			while (!se_gen_prng128(random_numbers))
+				;
+			// Clamp 4KB aligned offsets to 512MB range. Upper bits select the operation on mixed tests.
+			for (u32 j = 0; j < 4; j++)
+			{
+				wr[i + j].sector = offset_chunk_start + ((random_numbers[j] % 0x100000) & ~7);
+				wr[i + j].num_sectors = 8;
+				wr[i + j].buf = (u8 *)MIXD_BUF_ALIGNED + (i + j) * 0x1000;
+				random_ops[i + j] = (random_numbers[j] >> 20) % 100;
+			}
+		}
+
+		for (u32 i = 0; i < BENCH_MIXED_OPS && !error; i++)
+			error = !sdmmc_storage_read(storage, wr[i].sector, 8, wr[i].buf);
+
+		timer = 0;
+		for (u32 i = 0; i < BENCH_MIXED_OPS && !error; i++)
+		{
+			u32 time_taken = get_tmr_us();
+			error = !sdmmc_storage_write(storage, wr[i].sector, 8, wr[i].buf);
+			time_taken = get_tmr_us() - time_taken;
+			timer += time_taken;
+			_bench_lat_add(lat, time_taken);
+
+			if (!(i % 64))
+			{
+				lv_bar_set_value(bar, (i * 100) / BENCH_MIXED_OPS);
+				manual_system_maintenance(true);
+
+				if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+					error = -1;
+			}
+		}
+		lv_bar_set_value(bar, 100);
+
 		if (error)
+			goto error_wr;
+
+		u32 iops = ((u64)BENCH_MIXED_OPS * 1000000) / timer;
+		s_printf(txt_buf + strlen(txt_buf),
+			" Random      4KiB - IOPS: #C7EA46 %4d#, p50/p99/max: #C7EA46 %d/%d/%d# us\n",
+			iops, _bench_lat_percentile(lat, 50), _bench_lat_percentile(lat, 99), lat->max);
+		_bench_csv_add(csv_buf, "rnd_write_4k", offset_chunk_start, iops * 4, iops, lat);
+
+		// eMMC packed writes.
+		if (!sd_bench)
 		{
-			if (error == -1)
-				s_printf(txt_buf + strlen(txt_buf), "\n#FFDD00 Aborted!#");
-			else
-				s_printf(txt_buf + strlen(txt_buf), "\n#FFDD00 IO Error occurred!#");
+			u32 wr_max = MIN(MAX(storage->ext_csd.max_packed_wr, 1), 32);
 
+			timer = get_tmr_us();
+			for (u32 i = 0; i < BENCH_MIXED_OPS && !error; i += wr_max)
+				error = !sdmmc_storage_write_packed(storage, &wr[i], MIN(wr_max, BENCH_MIXED_OPS - i));
+			timer = get_tmr_us() - timer;
+
+			if (error)
+				goto error_wr;
+
+			iops = ((u64)BENCH_MIXED_OPS * 1000000) / timer;
+			s_printf(txt_buf + strlen(txt_buf),
+				" Random      4KiB - Impacchettata (x%d) IOPS: #C7EA46 %4d#\n", wr_max, iops);
+			_bench_csv_add(csv_buf, "rnd_write_4k_packed", offset_chunk_start, iops * 4, iops, NULL);
+		}
+		lv_label_set_text(lbl_status, txt_buf);
+		lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+		lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+		manual_system_maintenance(true);
+
+		// Mixed reads/writes. Reads refill the same buffers, so written data always matches the backup.
+		static const u32 mixed_read_pct[] = { 70, 50 };
+		for (u32 ratio = 0; ratio < ARRAY_SIZE(mixed_read_pct); ratio++)
+		{
+			memset(lat, 0, sizeof(bench_lat_t));
+			timer = 0;
+			for (u32 i = 0; i < BENCH_MIXED_OPS && !error; i++)
+			{
+				u32 time_taken = get_tmr_us();
+				if (random_ops[i] < mixed_read_pct[ratio])
+					error = !sdmmc_storage_read(storage, wr[i].sector, 8, wr[i].buf);
+				else
+					error = !sdmmc_storage_write(storage, wr[i].sector, 8, wr[i].buf);
+				time_taken = get_tmr_us() - time_taken;
+				timer += time_taken;
+				_bench_lat_add(lat, time_taken);
+
+				if (!(i % 64))
+				{
+					lv_bar_set_value(bar, (i * 100) / BENCH_MIXED_OPS);
+					manual_system_maintenance(true);
+
+					if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+						error = -1;
+				}
+			}
+			lv_bar_set_value(bar, 100);
+
+			if (error)
+				goto error_wr;
+
+			char test_name[16];
+			iops = ((u64)BENCH_MIXED_OPS * 1000000) / timer;
+			s_printf(txt_buf + strlen(txt_buf),
+				" Misto %d/%d 4KiB - IOPS: #C7EA46 %4d#, p50/p99/max: #C7EA46 %d/%d/%d# us\n",
+				mixed_read_pct[ratio], 100 - mixed_read_pct[ratio], iops,
+				_bench_lat_percentile(lat, 50), _bench_lat_percentile(lat, 99), lat->max);
+			s_printf(test_name, "mixed_%d_%d_4k", mixed_read_pct[ratio], 100 - mixed_read_pct[ratio]);
+			_bench_csv_add(csv_buf, test_name, offset_chunk_start, iops * 4, iops, lat);
 			lv_label_set_text(lbl_status, txt_buf);
 			lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+			lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+			manual_system_maintenance(true);
+		}
+
+		// Append the sequential write timeline.
+		s_printf(csv_buf + strlen(csv_buf), "\nsecond,seq_write_kib_s\n");
+		for (u32 i = 0; i < timeline_cnt; i++)
+			s_printf(csv_buf + strlen(csv_buf), "%d,%d\n", i + 1, timeline[i]);
+
+error_wr:
+		free(wr);
+		free(random_ops);
+		free(lat);
+		free(timeline);
+
+skip_wr:
+error:
+		if (error)
+		{
+			if (error == -1)
+				s_printf(txt_buf + strlen(txt_buf), "#FFDD00 Aborted!#");
+			else
+				s_printf(txt_buf + strlen(txt_buf), "#FFDD00 IO Error occurred!#");
 		}
 
 		lv_obj_del(bar);
@@ -1471,6 +1855,26 @@ error:
 			sd_unmount();
 		else
 			sdmmc_storage_end(&emmc_storage);
+
+		// Export results to SD.
+		if (!error)
+		{
+			char path[64];
+
+			s_printf(csv_buf + strlen(csv_buf), "\nmaint,bpmp_cycles\nall_ways,%d\nrange_512,%d\nrange_4k,%d\n",
+				maint_cycles[0], maint_cycles[1], maint_cycles[2]);
+
+			s_printf(path, "bootloader/bench_%s_%08X.csv", sd_bench ? "sd" : "emmc", storage->cid.serial);
+			if (!sd_mount() || sd_save_to_file(csv_buf, strlen(csv_buf), path))
+				s_printf(txt_buf + strlen(txt_buf), "#FFDD00 Salvataggio CSV fallito!#");
+			else
+				s_printf(txt_buf + strlen(txt_buf), "CSV salvato in #C7EA46 %s#", path);
+			sd_unmount();
+		}
+
+		lv_label_set_text(lbl_status, txt_buf);
+		lv_obj_align(lbl_status, NULL, LV_ALIGN_CENTER, 0, 0);
+		free(csv_buf);
 	}
 	free(txt_buf);
 
@@ -1494,6 +1898,71 @@ static lv_res_t _create_mbox_sd_bench(lv_obj_t * btn)
 	return LV_RES_OK;
 }
 
+static lv_obj_t *discard_mbox;
+static u32 discard_pct;
+
+static void _sd_discard_progress(DWORD done, DWORD total)
+{
+	u32 pct = (u64)done * 100 / total;
+	if (pct == discard_pct)
+		return;
+
+	char txt_buf[128];
+	discard_pct = pct;
+	s_printf(txt_buf, "#FF8000 Scarta spazio libero#\n\nInformando la scheda SD dei cluster liberi... %d%%", pct);
+	lv_mbox_set_text(discard_mbox, txt_buf);
+	manual_system_maintenance(true);
+}
+
+static lv_res_t _create_mbox_sd_discard(lv_obj_t * btn)
+{
+	lv_obj_t *dark_bg = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_style(dark_bg, &mbox_darken);
+	lv_obj_set_size(dark_bg, LV_HOR_RES, LV_VER_RES);
+
+	static const char * mbox_btn_map[] = { "\211", "\222OK", "\211", "" };
+	lv_obj_t * mbox = lv_mbox_create(dark_bg, NULL);
+	lv_mbox_set_recolor_text(mbox, true);
+	lv_obj_set_width(mbox, LV_HOR_RES / 9 * 5);
+
+	char *txt_buf = (char *)malloc(0x1000);
+
+	lv_mbox_set_text(mbox, "#FF8000 Scarta spazio libero#\n\nInformando la scheda SD dei cluster liberi...");
+	lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+	lv_obj_set_top(mbox, true);
+	manual_system_maintenance(true);
+
+	if (!sd_mount())
+		s_printf(txt_buf, "#FFDD00 Inizializzazione SD fallita!#");
+	else
+	{
+		DWORD nclst = 0;
+		discard_mbox = mbox;
+		discard_pct = 0;
+		u32 timer = get_tmr_ms();
+		int res = f_discard_free("", &nclst, _sd_discard_progress);
+		timer = get_tmr_ms() - timer;
+
+		// Convert discarded clusters to MiB.
+		u32 discarded_mb = ((u64)nclst * sd_fs.csize) >> SECTORS_TO_MIB_COEFF;
+		if (res)
+			s_printf(txt_buf, "#FFDD00 Scarto fallito (%d) dopo# #C7EA46 %d# #FFDD00 MiB!#", res, discarded_mb);
+		else
+			s_printf(txt_buf, "#FF8000 Scarta spazio libero#\n\nScartati #C7EA46 %d# MiB in #C7EA46 %d.%d# s.",
+				discarded_mb, timer / 1000, (timer % 1000) / 100);
+
+		sd_unmount();
+	}
+
+	lv_mbox_set_text(mbox, txt_buf);
+	free(txt_buf);
+
+	lv_mbox_add_btns(mbox, mbox_btn_map, mbox_action); // Important. After set_text.
+	lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+
+	return LV_RES_OK;
+}
+
 static lv_res_t _create_window_emmc_info_status(lv_obj_t *btn)
 {
 	lv_obj_t *win = nyx_create_standard_window(SYMBOL_CHIP" Info eMMC interna");
@@ -1714,6 +2183,7 @@ static lv_res_t _create_window_sdcard_info_status(lv_obj_t *btn)
 {
 	lv_obj_t *win = nyx_create_standard_window(SYMBOL_SD" Info scheda microSD");
 	lv_win_add_btn(win, NULL, SYMBOL_SD" Benchmark", _create_mbox_sd_bench);
+	lv_win_add_btn(win, NULL, SYMBOL_TRASH" Scarta libero", _create_mbox_sd_discard);
 
 	lv_obj_t *desc = lv_cont_create(win, NULL);
 	lv_obj_set_size(desc, LV_HOR_RES / 2 / 5 * 2, LV_VER_RES - (LV_DPI * 11 / 8) * 5 / 2);
@@ -1946,7 +2416,8 @@ static lv_res_t _create_window_sdcard_info_status(lv_obj_t *btn)
 			"#00DDFF Errori SDMMC1:#\n"
 			"Problemi init:\n"
 			"Prob. lett./scritt.:\n"
-			"Err. lett./scritt.:"
+			"Err. lett./scritt.:\n"
+			"Buffer rimbalzo:"
 		);
 		lv_obj_set_size(desc4, LV_HOR_RES / 2 / 5 * 2, LV_VER_RES - (LV_DPI * 11 / 8) * 4);
 		lv_obj_set_width(lb_desc4, lv_obj_get_width(desc4));
@@ -1958,8 +2429,9 @@ static lv_res_t _create_window_sdcard_info_status(lv_obj_t *btn)
 		lv_obj_t * lb_val4 = lv_label_create(val4, lb_desc);
 
 		u16 *sd_errors = sd_get_error_count();
-		s_printf(txt_buf, "\n%d (%d)\n%d (%d)\n%d (%d)",
-			sd_errors[0], nyx_str->info.sd_errors[0], sd_errors[1], nyx_str->info.sd_errors[1], sd_errors[2], nyx_str->info.sd_errors[2]);
+		s_printf(txt_buf, "\n%d (%d)\n%d (%d)\n%d (%d)\n%d (%d KiB)",
+			sd_errors[0], nyx_str->info.sd_errors[0], sd_errors[1], nyx_str->info.sd_errors[1], sd_errors[2], nyx_str->info.sd_errors[2],
+			sd_storage.bounce_cnt, (u32)(sd_storage.bounce_bytes >> 10));
 
 		lv_label_set_text(lb_val4, txt_buf);
 
@@ -1975,6 +2447,159 @@ static lv_res_t _create_window_sdcard_info_status(lv_obj_t *btn)
 	return LV_RES_OK;
 }
 
+#define BTRACE_BAR_W 36
+
+static const char *btrace_names[BT_PHASE_MAX] = {
+	"HW/DRAM",
+	"Mount SD",
+	"LP0/Minerva",
+	"Schermo",
+	"Autoboot",
+	"Parsing ini",
+	"Avvio Nyx",
+	"Avvio HOS",
+	"Init eMMC",
+	"Lettura pkg1",
+	"Config avvio",
+	"Parsing FSS0",
+	"Keygen",
+	"Pkg1/secmon",
+	"Lettura pkg2",
+	"Decritt. pkg2",
+	"Parsing INI1",
+	"Patch kip",
+	"Build pkg2",
+	"Cache config"
+};
+
+static void _btrace_waterfall(char *txt_buf, btrace_t *bt)
+{
+	if (bt->magic != BTRACE_MAGIC || !bt->idx)
+	{
+		strcat(txt_buf, "#FFDD00 Nessun dato.#\n");
+		return;
+	}
+
+	u32 cnt = MIN(bt->idx, BTRACE_ENTRIES);
+	u32 first = bt->idx - cnt;
+	u32 t_start = bt->entry[first % BTRACE_ENTRIES].ts_us;
+	u32 t_last = bt->entry[(bt->idx - 1) % BTRACE_ENTRIES].ts_us;
+	u32 span = MAX(t_last - t_start, 1);
+	u32 depth = 0;
+
+	s_printf(txt_buf + strlen(txt_buf),
+		"#FF8000 Fase             Inizio Durata#      Totale: %d.%03d s\n",
+		span / 1000000, (span % 1000000) / 1000);
+
+	for (u32 i = first; i < bt->idx; i++)
+	{
+		btrace_entry_t *entry = &bt->entry[i % BTRACE_ENTRIES];
+		u32 id = entry->id & ~BTRACE_END;
+
+		if (entry->id & BTRACE_END)
+		{
+			if (depth)
+				depth--;
+			continue;
+		}
+
+		// Find phase end. If it's missing, the phase never finished.
+		u32 t_end = t_last;
+		bool open = true;
+		for (u32 j = i + 1; j < bt->idx; j++)
+		{
+			btrace_entry_t *end = &bt->entry[j % BTRACE_ENTRIES];
+			if (end->id == (id | BTRACE_END))
+			{
+				t_end = end->ts_us;
+				open = false;
+				break;
+			}
+		}
+
+		// Name, indented by nesting.
+		char *txt = txt_buf + strlen(txt_buf);
+		u32 pos = 0;
+		for (u32 k = 0; k < depth && k < 3; k++)
+			txt[pos++] = ' ';
+		const char *name = id < BT_PHASE_MAX ? btrace_names[id] : "?";
+		for (u32 k = 0; name[k] && pos < 16; k++)
+			txt[pos++] = name[k];
+		while (pos < 16)
+			txt[pos++] = ' ';
+		txt[pos] = 0;
+
+		u32 start_ms = (entry->ts_us - t_start) / 1000;
+		u32 dur_ms = (t_end - entry->ts_us) / 1000;
+		s_printf(txt + pos, " %6d %6d%s ms [", start_ms, dur_ms, open ? "+" : " ");
+
+		// Bar.
+		u32 bar_start = (u64)(entry->ts_us - t_start) * BTRACE_BAR_W / span;
+		u32 bar_len = MAX((u64)(t_end - entry->ts_us) * BTRACE_BAR_W / span, 1);
+		if (bar_start >= BTRACE_BAR_W)
+			bar_start = BTRACE_BAR_W - 1;
+		if (bar_start + bar_len > BTRACE_BAR_W)
+			bar_len = BTRACE_BAR_W - bar_start;
+
+		txt += strlen(txt);
+		pos = 0;
+		for (u32 k = 0; k < bar_start; k++)
+			txt[pos++] = ' ';
+		strcpy(txt + pos, open ? "#FFDD00 " : "#C7EA46 ");
+		pos += 8;
+		for (u32 k = 0; k < bar_len; k++)
+			txt[pos++] = '=';
+		txt[pos++] = '#';
+		for (u32 k = bar_start + bar_len; k < BTRACE_BAR_W; k++)
+			txt[pos++] = ' ';
+		strcpy(txt + pos, "]\n");
+
+		depth++;
+	}
+}
+
+static lv_res_t _create_window_boot_trace(lv_obj_t *btn)
+{
+	lv_obj_t *win = nyx_create_standard_window(SYMBOL_CLOCK" Tempi di avvio");
+
+	lv_obj_t *desc = lv_cont_create(win, NULL);
+	lv_obj_set_size(desc, LV_HOR_RES * 10 / 11, LV_VER_RES - (LV_DPI * 11 / 7));
+
+	lv_obj_t *lb_desc = lv_label_create(desc, NULL);
+	lv_label_set_long_mode(lb_desc, LV_LABEL_LONG_BREAK);
+	lv_label_set_recolor(lb_desc, true);
+	lv_label_set_style(lb_desc, &monospace_text);
+	lv_obj_set_width(lb_desc, lv_obj_get_width(desc));
+
+	char *txt_buf = (char *)malloc(0x4000);
+
+	strcpy(txt_buf, "#00DDFF Avvio attuale (hekate -> Nyx):#\n");
+	if (nyx_str->info.magic == NYX_NEW_INFO)
+		_btrace_waterfall(txt_buf, (btrace_t *)&nyx_str->info.btrace);
+	else
+		strcat(txt_buf, "#FFDD00 Nessun dato.#\n");
+
+	strcat(txt_buf, "\n#00DDFF Ultimo avvio HOS:#\n");
+	u32 size = 0;
+	btrace_t *bt = NULL;
+	if (sd_mount())
+	{
+		bt = (btrace_t *)sd_file_read("bootloader/boot_trace.bin", &size);
+		sd_unmount();
+	}
+
+	if (bt && size == sizeof(btrace_t))
+		_btrace_waterfall(txt_buf, bt);
+	else
+		strcat(txt_buf, "#FFDD00 Nessun dato. Imposta# #C7EA46 boottrace=1# #FFDD00 in hekate_ipl.ini.#\n");
+	free(bt);
+
+	lv_label_set_text(lb_desc, txt_buf);
+	free(txt_buf);
+
+	return LV_RES_OK;
+}
+
 static lv_res_t _create_window_battery_status(lv_obj_t *btn)
 {
 	lv_obj_t *win = nyx_create_standard_window(SYMBOL_BATTERY_FULL" Info Batteria");
@@ -2377,11 +3002,19 @@ void create_tab_info(lv_theme_t *th, lv_obj_t *parent)
 	lv_obj_align(btn7, line_sep, LV_ALIGN_OUT_BOTTOM_LEFT, LV_DPI / 4, LV_DPI / 2);
 	lv_btn_set_action(btn7, LV_BTN_ACTION_CLICK, _create_window_battery_status);
 
+	// Create Boot trace button.
+	lv_obj_t *btn8 = lv_btn_create(h2, btn);
+	label_btn = lv_label_create(btn8, NULL);
+	lv_label_set_static_text(label_btn, SYMBOL_CLOCK"  Tempi avvio");
+	lv_obj_align(btn8, btn7, LV_ALIGN_OUT_RIGHT_TOP, LV_DPI * 3 / 4, 0);
+	lv_btn_set_action(btn8, LV_BTN_ACTION_CLICK, _create_window_boot_trace);
+
 	lv_obj_t *label_txt6 = lv_label_create(h2, NULL);
 	lv_label_set_recolor(label_txt6, true);
 	lv_label_set_static_text(label_txt6,
 		"Visualizza informazioni riguardo la batteria e il caricatore.\n"
-		"Inoltre puoi salvare i registri del caricatore.\n");
+		"Inoltre puoi salvare i registri del caricatore.\n"
+		"O visualizza i #C7EA46 tempi delle fasi di avvio#.");
 	lv_obj_set_style(label_txt6, &hint_small_style);
 	lv_obj_align(label_txt6, btn7, LV_ALIGN_OUT_BOTTOM_LEFT, 0, LV_DPI / 3);
 }
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "gui.h"
+#include "gui_profiler.h"
+#include <libs/fatfs/ff.h>
+#include <mem/heap.h>
+#include <storage/nx_sd.h>
+#include <utils/sprintf.h>
+#include <utils/util.h>
+
+#define GUI_PROF_CSV_PATH "bootloader/nyx_profile.csv"
+
+static const char *prof_chan_names[GUI_PROF_MAX] = {
+	"frame", "refresh", "touch_read", "jc_read", "status_bar"
+};
+
+// Main tab order, as in gui_timing.tab_build_us.
+static const char *prof_tab_names[5] = {
+	"about", "home", "tools", "info", "options"
+};
+
+static bool prof_enabled = false;
+static gui_prof_chan_t prof_chan[GUI_PROF_MAX];
+static lv_obj_t *prof_label = NULL;
+
+static u32 _gui_prof_bin(u32 time_us)
+{
+	u32 bin = 0;
+
+	while (time_us > 1 && bin < (GUI_PROF_HIST_BINS - 1))
+	{
+		time_us >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+// Bin that contains the requested percentile.
+static u32 _gui_prof_percentile(gui_prof_chan_t *chan, u32 pct)
+{
+	u32 samples = MIN(chan->count, GUI_PROF_RING_SZ);
+	u32 target = (samples * pct + 99) / 100;
+	u32 acc = 0;
+
+	for (u32 bin = 0; bin < GUI_PROF_HIST_BINS; bin++)
+	{
+		acc += chan->hist[bin];
+		if (acc >= target)
+			return bin;
+	}
+
+	return 0;
+}
+
+// Bin range. The last bin is open-ended.
+static void _gui_prof_bin_str(char *buf, u32 bin)
+{
+	if (bin < (GUI_PROF_HIST_BINS - 1))
+		s_printf(buf, "<%d", 2 << bin);
+	else
+		s_printf(buf, ">=%d", 1 << bin);
+}
+
+void gui_prof_init(bool enable)
+{
+	memset(prof_chan, 0, sizeof(prof_chan));
+	for (u32 i = 0; i < GUI_PROF_MAX; i++)
+		prof_chan[i].min = 0xFFFFFFFF;
+
+	prof_label = NULL;
+	prof_enabled = enable;
+}
+
+bool gui_prof_enabled()
+{
+	return prof_enabled;
+}
+
+void gui_prof_add(u32 chan_idx, u32 time_us)
+{
+	if (!prof_enabled || chan_idx >= GUI_PROF_MAX)
+		return;
+
+	gui_prof_chan_t *chan = &prof_chan[chan_idx];
+
+	// Evict the oldest sample from the rolling histogram.
+	if (chan->count >= GUI_PROF_RING_SZ)
+		chan->hist[_gui_prof_bin(chan->ring[chan->ring_idx])]--;
+
+	chan->ring[chan->ring_idx] = time_us;
+	chan->ring_idx = (chan->ring_idx + 1) % GUI_PROF_RING_SZ;
+	chan->hist[_gui_prof_bin(time_us)]++;
+
+	chan->count++;
+	chan->sum += time_us;
+	if (time_us < chan->min)
+		chan->min = time_us;
+	if (time_us > chan->max)
+		chan->max = time_us;
+}
+
+static void _gui_prof_update_overlay(void *param)
+{
+	char *txt_buf = (char *)malloc(0x400);
+	char p50[16], p99[16];
+	txt_buf[0] = 0;
+
+	for (u32 i = 0; i < GUI_PROF_MAX; i++)
+	{
+		gui_prof_chan_t *chan = &prof_chan[i];
+		if (!chan->count)
+			continue;
+
+		_gui_prof_bin_str(p50, _gui_prof_percentile(chan, 50));
+		_gui_prof_bin_str(p99, _gui_prof_percentile(chan, 99));
+		s_printf(txt_buf + strlen(txt_buf), "%s: avg %d p50 %s p99 %s max %d us\n",
+			prof_chan_names[i], (u32)(chan->sum / chan->count), p50, p99, chan->max);
+	}
+
+	s_printf(txt_buf + strlen(txt_buf), "startup: %d us, last window: %d us\n",
+		gui_timing.interactive_us, gui_timing.win_open_us);
+
+	lv_label_set_text(prof_label, txt_buf);
+
+	free(txt_buf);
+}
+
+static lv_res_t _gui_prof_save_action(lv_obj_t *btn)
+{
+	lv_obj_t *mbox = lv_mbox_create(lv_layer_top(), NULL);
+	lv_mbox_set_recolor_text(mbox, true);
+	lv_obj_set_width(mbox, LV_DPI * 5);
+	lv_obj_set_top(mbox, true);
+	lv_obj_align(mbox, NULL, LV_ALIGN_IN_TOP_LEFT, 0, 0);
+
+	if (!gui_prof_save_csv(GUI_PROF_CSV_PATH))
+		lv_mbox_set_text(mbox, SYMBOL_SD"  #96FF00 Profilo salvato in# "GUI_PROF_CSV_PATH);
+	else
+		lv_mbox_set_text(mbox, SYMBOL_WARNING"  #FFDD00 Salvataggio profilo fallito!#");
+
+	manual_system_maintenance(true);
+	lv_mbox_start_auto_close(mbox, 4000);
+
+	return LV_RES_OK;
+}
+
+void gui_prof_create_overlay()
+{
+	if (!prof_enabled)
+		return;
+
+	static lv_style_t prof_style;
+	lv_style_copy(&prof_style, &monospace_text);
+	prof_style.body.main_color = LV_COLOR_BLACK;
+	prof_style.body.grad_color = prof_style.body.main_color;
+	prof_style.body.opa = LV_OPA_60;
+	prof_style.body.padding.hor = LV_DPI / 10;
+	prof_style.body.padding.ver = LV_DPI / 20;
+	prof_style.text.font = &interui_20;
+
+	// Tap the overlay to dump the profile to SD.
+	lv_obj_t *btn = lv_btn_create(lv_layer_top(), NULL);
+	lv_btn_set_style(btn, LV_BTN_STYLE_REL, &prof_style);
+	lv_btn_set_style(btn, LV_BTN_STYLE_PR, &prof_style);
+	lv_btn_set_fit(btn, true, true);
+	lv_btn_set_action(btn, LV_BTN_ACTION_CLICK, _gui_prof_save_action);
+	lv_obj_set_pos(btn, LV_DPI / 4, LV_VER_RES - LV_DPI * 2);
+
+	prof_label = lv_label_create(btn, NULL);
+	lv_label_set_style(prof_label, &prof_style);
+	lv_label_set_static_text(prof_label, "");
+
+	lv_task_create(_gui_prof_update_overlay, 1000, LV_TASK_PRIO_LOWEST, NULL);
+}
+
+int gui_prof_save_csv(const char *path)
+{
+	FIL fp;
+	char *txt_buf = (char *)malloc(0x200);
+
+	if (!sd_mount())
+		goto error;
+
+	if (f_open(&fp, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+		goto error_unmount;
+
+	// Summary and rolling histogram per channel. Bin N counts samples below 2^(N + 1) us, the last one the rest.
+	f_puts("channel,count,min_us,max_us,avg_us", &fp);
+	for (u32 bin = 0; bin < GUI_PROF_HIST_BINS; bin++)
+	{
+		if (bin < (GUI_PROF_HIST_BINS - 1))
+			s_printf(txt_buf, ",lt_%d_us", 2 << bin);
+		else
+			s_printf(txt_buf, ",ge_%d_us", 1 << bin);
+		f_puts(txt_buf, &fp);
+	}
+	f_puts("\n", &fp);
+
+	for (u32 i = 0; i < GUI_PROF_MAX; i++)
+	{
+		gui_prof_chan_t *chan = &prof_chan[i];
+
+		s_printf(txt_buf, "%s,%d,%d,%d,%d", prof_chan_names[i], chan->count,
+			chan->count ? chan->min : 0, chan->max, chan->count ? (u32)(chan->sum / chan->count) : 0);
+		f_puts(txt_buf, &fp);
+
+		for (u32 bin = 0; bin < GUI_PROF_HIST_BINS; bin++)
+		{
+			s_printf(txt_buf, ",%d", chan->hist[bin]);
+			f_puts(txt_buf, &fp);
+		}
+		f_puts("\n", &fp);
+	}
+
+	// Startup and window latencies. Tabs not opened yet are 0.
+	s_printf(txt_buf, "\ntiming,us\ninteractive,%d\n", gui_timing.interactive_us);
+	f_puts(txt_buf, &fp);
+	for (u32 i = 0; i < ARRAY_SIZE(gui_timing.tab_build_us); i++)
+	{
+		s_printf(txt_buf, "tab_build_%s,%d\n", prof_tab_names[i], gui_timing.tab_build_us[i]);
+		f_puts(txt_buf, &fp);
+	}
+	s_printf(txt_buf, "win_open,%d\n", gui_timing.win_open_us);
+	f_puts(txt_buf, &fp);
+
+	f_close(&fp);
+	sd_unmount();
+	free(txt_buf);
+
+	return 0;
+
+error_unmount:
+	sd_unmount();
+error:
+	free(txt_buf);
+
+	return 1;
+}
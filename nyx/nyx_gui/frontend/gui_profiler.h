@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GUI_PROFILER_H_
+#define _GUI_PROFILER_H_
+
+#include <libs/lvgl/lvgl.h>
+#include <utils/types.h>
+
+#define GUI_PROF_HIST_BINS 16  // Power of 2 us bins. Last one is 32.768 ms and up.
+#define GUI_PROF_RING_SZ   256 // Samples kept per channel for the rolling histogram.
+
+enum
+{
+	GUI_PROF_FRAME      = 0, // Time between refresh completions.
+	GUI_PROF_REFRESH    = 1, // Rendering time of a refresh.
+	GUI_PROF_TOUCH_READ = 2,
+	GUI_PROF_JC_READ    = 3,
+	GUI_PROF_STATUS_BAR = 4,
+	GUI_PROF_MAX        = 5
+};
+
+typedef struct _gui_prof_chan_t
+{
+	u32 count;
+	u32 min;
+	u32 max;
+	u64 sum;
+	u32 hist[GUI_PROF_HIST_BINS]; // Histogram of the samples in ring.
+	u32 ring[GUI_PROF_RING_SZ];
+	u32 ring_idx;
+} gui_prof_chan_t;
+
+void gui_prof_init(bool enable);
+bool gui_prof_enabled();
+void gui_prof_add(u32 chan, u32 time_us);
+void gui_prof_create_overlay();
+int  gui_prof_save_csv(const char *path);
+
+#endif
@@ -41,6 +41,7 @@
 #include <storage/sdmmc.h>
 #include <usb/usbd.h>
 #include <utils/btn.h>
+#include <utils/ini.h>
 #include <utils/sprintf.h>
 #include <utils/util.h>
 
@@ -296,6 +297,9 @@ static lv_res_t _create_mbox_ums(usb_ctxt_t *usbs)
 
 	usb_device_gadget_ums(usbs);
 
+	// Config files may have been edited by the host.
+	ini_arena_drop(NULL);
+
 	// Restore backlight.
 	display_backlight_brightness(h_cfg.backlight - 20, 1000);
 
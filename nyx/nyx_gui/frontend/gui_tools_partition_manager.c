@@ -1556,6 +1556,7 @@ static lv_res_t _create_mbox_start_partitioning(lv_obj_t *btn)
 	goto out;
 
 error:
+	f_mount(NULL, "ram:", 1); // Unmount ramdisk. ram_fs is on the stack.
 	f_chdrive("sd:");
 	free(path);
 
@@ -2067,24 +2068,7 @@ static lv_res_t _action_fix_mbr(lv_obj_t *btn)
 
 	// Parse GPT.
 	LIST_INIT(gpt_parsed);
-	for (u32 i = 0; i < gpt->header.num_part_ents; i++)
-	{
-		emmc_part_t *part = (emmc_part_t *)calloc(sizeof(emmc_part_t), 1);
-
-		if (gpt->entries[i].lba_start < gpt->header.first_use_lba)
-			continue;
-
-		part->index = i;
-		part->lba_start = gpt->entries[i].lba_start;
-		part->lba_end = gpt->entries[i].lba_end;
-
-		// ASCII conversion. Copy only the LSByte of the UTF-16LE name.
-		for (u32 j = 0; j < 36; j++)
-			part->name[j] = gpt->entries[i].name[j];
-		part->name[35] = 0;
-
-		list_append(&gpt_parsed, &part->link);
-	}
+	nx_emmc_gpt_parse_buf(&gpt_parsed, gpt);
 	free(gpt);
 
 	// Set FAT and emuMMC partitions.
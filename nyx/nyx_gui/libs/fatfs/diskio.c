@@ -113,6 +113,10 @@ DRESULT disk_ioctl (
 		case GET_BLOCK_SIZE:
 			*buf = 32768; // Align to 16MB.
 			break;
+		case CTRL_TRIM:
+			if (!sdmmc_storage_discard(&sd_storage, buf[0], buf[1] - buf[0] + 1))
+				return RES_ERROR;
+			break;
 		}
 	}
 	else if (pdrv == DRIVE_RAM)
@@ -218,7 +218,7 @@
 /  GET_SECTOR_SIZE command. */
 
 
-#define FF_USE_TRIM		0
+#define FF_USE_TRIM		1
 /* This option switches support for ATA-TRIM. (0:Disable or 1:Enable)
 /  To enable Trim function, also CTRL_TRIM command should be implemented to the
 /  disk_ioctl() function. */
@@ -248,6 +248,18 @@
 /  buffer in the filesystem object (FATFS) is used for the file data transfer. */
 
 
+#define FF_WIN_CACHE_SECTORS	128
+#define FF_WIN_CACHE_WAYS		4
+#define FF_WIN_CACHE_RA			8
+/* FF_WIN_CACHE_SECTORS sets the number of sectors cached behind the disk access
+/  window (FAT, allocation bitmap and directory sectors). 0 disables the cache.
+/  The cache is allocated with ff_memalloc() on mount and dirty sectors are only
+/  written back by f_sync(), f_close() and the functions that modify the volume.
+/  FF_WIN_CACHE_WAYS sets its associativity and must divide FF_WIN_CACHE_SECTORS.
+/  FF_WIN_CACHE_RA sets the number of FAT/bitmap sectors read at once on a miss.
+/  Requires FF_FS_TINY == 0. */
+
+
 #define FF_FS_EXFAT		1
 /* This option switches support for exFAT filesystem. (0:Disable or 1:Enable)
 /  To enable exFAT, also LFN needs to be enabled. (FF_USE_LFN >= 1)
@@ -230,76 +230,69 @@ out:
 
 void load_saved_configuration()
 {
-	LIST_INIT(ini_sections);
-	LIST_INIT(ini_nyx_sections);
-
-	// Load hekate configuration.
-	if (ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false))
+	char *val;
+
+	// Load hekate configuration. Lookups are served from the config arena.
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "autoboot");
+	if (val)
+		h_cfg.autoboot = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "autoboot_list");
+	if (val)
+		h_cfg.autoboot_list = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "bootwait");
+	if (val)
+		h_cfg.bootwait = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "backlight");
+	if (val)
 	{
-		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_sections, link)
-		{
-			// Only parse config section.
-			if (ini_sec->type == INI_CHOICE && !strcmp(ini_sec->name, "config"))
-			{
-				LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
-				{
-					if (!strcmp("autoboot", kv->key))
-						h_cfg.autoboot = atoi(kv->val);
-					else if (!strcmp("autoboot_list", kv->key))
-						h_cfg.autoboot_list = atoi(kv->val);
-					else if (!strcmp("bootwait", kv->key))
-						h_cfg.bootwait = atoi(kv->val);
-					else if (!strcmp("backlight", kv->key))
-					{
-						h_cfg.backlight = atoi(kv->val);
-						if (h_cfg.backlight <= 20)
-							h_cfg.backlight = 30;
-					}
-					else if (!strcmp("autohosoff", kv->key))
-						h_cfg.autohosoff = atoi(kv->val);
-					else if (!strcmp("autonogc", kv->key))
-						h_cfg.autonogc = atoi(kv->val);
-					else if (!strcmp("updater2p", kv->key))
-						h_cfg.updater2p = atoi(kv->val);
-					else if (!strcmp("bootprotect", kv->key))
-						h_cfg.bootprotect = atoi(kv->val);
-				}
-
-				break;
-			}
-		}
+		h_cfg.backlight = atoi(val);
+		if (h_cfg.backlight <= 20)
+			h_cfg.backlight = 30;
 	}
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "autohosoff");
+	if (val)
+		h_cfg.autohosoff = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "autonogc");
+	if (val)
+		h_cfg.autonogc = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "updater2p");
+	if (val)
+		h_cfg.updater2p = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "bootprotect");
+	if (val)
+		h_cfg.bootprotect = atoi(val);
+	val = ini_arena_get("bootloader/hekate_ipl.ini", "config", "boottrace");
+	if (val)
+		h_cfg.boottrace = atoi(val);
 
 	// Load Nyx configuration.
-	if (ini_parse(&ini_nyx_sections, "bootloader/nyx.ini", false))
-	{
-		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_nyx_sections, link)
-		{
-			// Only parse config section.
-			if (ini_sec->type == INI_CHOICE && !strcmp(ini_sec->name, "config"))
-			{
-				LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
-				{
-					if (!strcmp("themecolor", kv->key))
-						n_cfg.themecolor = atoi(kv->val);
-					else if (!strcmp("timeoff", kv->key))
-						n_cfg.timeoff = strtol(kv->val, NULL, 16);
-					else if (!strcmp("homescreen", kv->key))
-						n_cfg.home_screen = atoi(kv->val);
-					else if (!strcmp("verification", kv->key))
-						n_cfg.verification = atoi(kv->val);
-					else if (!strcmp("umsemmcrw", kv->key))
-						n_cfg.ums_emmc_rw = atoi(kv->val) == 1;
-					else if (!strcmp("jcdisable", kv->key))
-						n_cfg.jc_disable = atoi(kv->val) == 1;
-					else if (!strcmp("newpowersave", kv->key))
-						n_cfg.new_powersave = atoi(kv->val) == 1;
-				}
-
-				break;
-			}
-		}
-	}
+	val = ini_arena_get("bootloader/nyx.ini", "config", "themecolor");
+	if (val)
+		n_cfg.themecolor = atoi(val);
+	val = ini_arena_get("bootloader/nyx.ini", "config", "timeoff");
+	if (val)
+		n_cfg.timeoff = strtol(val, NULL, 16);
+	val = ini_arena_get("bootloader/nyx.ini", "config", "homescreen");
+	if (val)
+		n_cfg.home_screen = atoi(val);
+	val = ini_arena_get("bootloader/nyx.ini", "config", "verification");
+	if (val)
+		n_cfg.verification = atoi(val);
+	val = ini_arena_get("bootloader/nyx.ini", "config", "umsemmcrw");
+	if (val)
+		n_cfg.ums_emmc_rw = atoi(val) == 1;
+	val = ini_arena_get("bootloader/nyx.ini", "config", "jcdisable");
+	if (val)
+		n_cfg.jc_disable = atoi(val) == 1;
+	val = ini_arena_get("bootloader/nyx.ini", "config", "newpowersave");
+	if (val)
+		n_cfg.new_powersave = atoi(val) == 1;
+	val = ini_arena_get("bootloader/nyx.ini", "config", "profiler");
+	if (val)
+		n_cfg.profiler = atoi(val) == 1;
+	val = ini_arena_get("bootloader/nyx.ini", "config", "emmcbulkwr");
+	if (val)
+		n_cfg.emmc_bulk_wr = atoi(val) == 1;
 }
 
 #define EXCP_EN_ADDR   0x4003FFFC
@@ -381,6 +374,9 @@ void nyx_init_load_res()
 	// Set display id from previous initialization.
 	display_set_decoded_panel_id(nyx_str->info.disp_id);
 
+	// Reuse config files already loaded by hekate.
+	ini_arena_init((void *)nyx_str->ini_arena, NYX_INI_ARENA_SZ, true);
+
 	// Initialize gfx console.
 	gfx_init_ctxt((u32 *)LOG_FB_ADDRESS, 1280, 656, 656);
 	gfx_con_init();
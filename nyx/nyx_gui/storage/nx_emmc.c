@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stddef.h>
 #include <string.h>
 
 #include "nx_emmc.h"
@@ -22,28 +23,101 @@
 #include <soc/fuse.h>
 #include <storage/mbr_gpt.h>
 #include <utils/list.h>
+#include <utils/util.h>
 
 sdmmc_t emmc_sdmmc;
 sdmmc_storage_t emmc_storage;
 FATFS emmc_fs;
 
-void nx_emmc_gpt_parse(link_t *gpt, sdmmc_storage_t *storage)
+#define NX_GPT_HDR_CMP_SIZE offsetof(gpt_header_t, res2)
+#define NX_GPT_IDX_SLOTS    8
+
+typedef struct _nx_gpt_idx_t
 {
-	gpt_t *gpt_buf = (gpt_t *)calloc(NX_GPT_NUM_BLOCKS, NX_EMMC_BLOCKSIZE);
+	u32 size;
+	u32 num_parts;
+	u8  sorted[128]; // Part slots sorted by name.
+	emmc_part_t parts[];
+} nx_gpt_idx_t;
 
-	sdmmc_storage_read(storage, NX_GPT_FIRST_LBA, NX_GPT_NUM_BLOCKS, gpt_buf);
+// Parsed lists that own an index. Keyed by the list head.
+typedef struct _nx_gpt_idx_slot_t
+{
+	link_t *gpt;
+	nx_gpt_idx_t *idx;
+} nx_gpt_idx_slot_t;
 
-	// Check if no GPT or more than max allowed entries.
-	if (memcmp(&gpt_buf->header.signature, "EFI PART", 8) || gpt_buf->header.num_part_ents > 128)
-		goto out;
+static nx_gpt_idx_slot_t _gpt_idx_slots[NX_GPT_IDX_SLOTS];
+static nx_gpt_idx_t *_gpt_cache = NULL;
+static u8 _gpt_cache_hdr[NX_GPT_HDR_CMP_SIZE];
 
-	for (u32 i = 0; i < gpt_buf->header.num_part_ents; i++)
+static nx_gpt_idx_slot_t *_nx_emmc_gpt_idx_slot(link_t *gpt)
+{
+	for (u32 i = 0; i < NX_GPT_IDX_SLOTS; i++)
 	{
-		emmc_part_t *part = (emmc_part_t *)calloc(sizeof(emmc_part_t), 1);
+		nx_gpt_idx_slot_t *slot = &_gpt_idx_slots[i];
+		if (slot->gpt != gpt)
+			continue;
 
+		// The head must still link to the index parts. Otherwise it was reused without a free.
+		if (gpt->next == &slot->idx->parts[0].link)
+			return slot;
+
+		slot->gpt = NULL;
+		slot->idx = NULL;
+	}
+
+	return NULL;
+}
+
+static void _nx_emmc_gpt_link(link_t *gpt, nx_gpt_idx_t *idx)
+{
+	for (u32 i = 0; i < NX_GPT_IDX_SLOTS; i++)
+	{
+		nx_gpt_idx_slot_t *slot = &_gpt_idx_slots[i];
+		if (slot->gpt && slot->gpt != gpt)
+			continue;
+
+		slot->gpt = gpt;
+		slot->idx = idx;
+		for (u32 j = 0; j < idx->num_parts; j++)
+			list_append(gpt, &idx->parts[j].link);
+
+		return;
+	}
+
+	// No free slot. Link plain copies that are freed one by one.
+	for (u32 i = 0; i < idx->num_parts; i++)
+	{
+		emmc_part_t *part = (emmc_part_t *)malloc(sizeof(emmc_part_t));
+		memcpy(part, &idx->parts[i], sizeof(emmc_part_t));
+		list_append(gpt, &part->link);
+	}
+
+	free(idx);
+}
+
+static nx_gpt_idx_t *_nx_emmc_gpt_idx_build(gpt_t *gpt_buf)
+{
+	u32 num_parts = 0;
+	for (u32 i = 0; i < gpt_buf->header.num_part_ents; i++)
+		if (gpt_buf->entries[i].lba_start >= gpt_buf->header.first_use_lba)
+			num_parts++;
+
+	if (!num_parts)
+		return NULL;
+
+	u32 size = sizeof(nx_gpt_idx_t) + num_parts * sizeof(emmc_part_t);
+	nx_gpt_idx_t *idx = (nx_gpt_idx_t *)calloc(size, 1);
+	idx->size = size;
+
+	for (u32 i = 0; i < gpt_buf->header.num_part_ents; i++)
+	{
 		if (gpt_buf->entries[i].lba_start < gpt_buf->header.first_use_lba)
 			continue;
 
+		emmc_part_t *part = &idx->parts[idx->num_parts];
+
 		part->index = i;
 		part->lba_start = gpt_buf->entries[i].lba_start;
 		part->lba_end = gpt_buf->entries[i].lba_end;
@@ -54,24 +128,136 @@ void nx_emmc_gpt_parse(link_t *gpt, sdmmc_storage_t *storage)
 			part->name[j] = gpt_buf->entries[i].name[j];
 		part->name[35] = 0;
 
-		list_append(gpt, &part->link);
+		// Stable insertion into the name index. Equal names keep GPT order.
+		u32 pos = idx->num_parts;
+		while (pos && strcmp(idx->parts[idx->sorted[pos - 1]].name, part->name) > 0)
+		{
+			idx->sorted[pos] = idx->sorted[pos - 1];
+			pos--;
+		}
+		idx->sorted[pos] = idx->num_parts;
+
+		idx->num_parts++;
 	}
 
+	return idx;
+}
+
+static nx_gpt_idx_t *_nx_emmc_gpt_idx_clone(nx_gpt_idx_t *src)
+{
+	nx_gpt_idx_t *idx = (nx_gpt_idx_t *)malloc(src->size);
+	memcpy(idx, src, src->size);
+
+	return idx;
+}
+
+static bool _nx_emmc_gpt_crc_valid(gpt_t *gpt_buf)
+{
+	gpt_header_t hdr;
+	memcpy(&hdr, &gpt_buf->header, sizeof(gpt_header_t));
+
+	if (hdr.size < NX_GPT_HDR_CMP_SIZE || hdr.size > sizeof(gpt_header_t) || hdr.part_ent_size != sizeof(gpt_entry_t))
+		return false;
+
+	hdr.crc32 = 0;
+	if (crc32_calc(0, (const u8 *)&hdr, hdr.size) != gpt_buf->header.crc32)
+		return false;
+
+	return crc32_calc(0, (const u8 *)gpt_buf->entries, sizeof(gpt_entry_t) * hdr.num_part_ents) == hdr.part_ents_crc32;
+}
+
+static void _nx_emmc_gpt_cache_update(gpt_t *gpt_buf, nx_gpt_idx_t *idx)
+{
+	free(_gpt_cache);
+	_gpt_cache = NULL;
+
+	// Only cache tables that their CRC32s vouch for, so a matching header also means matching entries.
+	if (!idx || !_nx_emmc_gpt_crc_valid(gpt_buf))
+		return;
+
+	_gpt_cache = _nx_emmc_gpt_idx_clone(idx);
+	memcpy(_gpt_cache_hdr, &gpt_buf->header, NX_GPT_HDR_CMP_SIZE);
+}
+
+void nx_emmc_gpt_parse_buf(link_t *gpt, gpt_t *gpt_buf)
+{
+	nx_gpt_idx_t *idx = _nx_emmc_gpt_idx_build(gpt_buf);
+	if (idx)
+		_nx_emmc_gpt_link(gpt, idx);
+}
+
+void nx_emmc_gpt_parse(link_t *gpt, sdmmc_storage_t *storage)
+{
+	gpt_t *gpt_buf = (gpt_t *)calloc(NX_GPT_NUM_BLOCKS, NX_EMMC_BLOCKSIZE);
+
+	// Read the header first. If it matches the cached one, so do the entries.
+	sdmmc_storage_read(storage, NX_GPT_FIRST_LBA, 1, gpt_buf);
+	if (_gpt_cache && !memcmp(&gpt_buf->header, _gpt_cache_hdr, NX_GPT_HDR_CMP_SIZE))
+	{
+		_nx_emmc_gpt_link(gpt, _nx_emmc_gpt_idx_clone(_gpt_cache));
+		goto out;
+	}
+
+	sdmmc_storage_read(storage, NX_GPT_FIRST_LBA + 1, NX_GPT_NUM_BLOCKS - 1, gpt_buf->entries);
+
+	// Check if no GPT or more than max allowed entries.
+	nx_gpt_idx_t *idx = NULL;
+	if (!memcmp(&gpt_buf->header.signature, "EFI PART", 8) && gpt_buf->header.num_part_ents <= 128)
+		idx = _nx_emmc_gpt_idx_build(gpt_buf);
+
+	_nx_emmc_gpt_cache_update(gpt_buf, idx);
+
+	if (idx)
+		_nx_emmc_gpt_link(gpt, idx);
+
 out:
 	free(gpt_buf);
 }
 
 void nx_emmc_gpt_free(link_t *gpt)
 {
+	nx_gpt_idx_slot_t *slot = _nx_emmc_gpt_idx_slot(gpt);
+	if (slot)
+	{
+		free(slot->idx);
+		slot->gpt = NULL;
+		slot->idx = NULL;
+		return;
+	}
+
 	LIST_FOREACH_SAFE(iter, gpt)
 		free(CONTAINER_OF(iter, emmc_part_t, link));
 }
 
 emmc_part_t *nx_emmc_part_find(link_t *gpt, const char *name)
 {
+	nx_gpt_idx_slot_t *slot = _nx_emmc_gpt_idx_slot(gpt);
+	if (slot)
+	{
+		nx_gpt_idx_t *idx = slot->idx;
+
+		// Binary search the name index for the first part with that name.
+		u32 lo = 0;
+		u32 hi = idx->num_parts;
+		while (lo < hi)
+		{
+			u32 mid = (lo + hi) >> 1;
+			if (strcmp(idx->parts[idx->sorted[mid]].name, name) < 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		if (lo < idx->num_parts && !strcmp(idx->parts[idx->sorted[lo]].name, name))
+			return &idx->parts[idx->sorted[lo]];
+
+		return NULL;
+	}
+
 	LIST_FOREACH_ENTRY(emmc_part_t, part, gpt, link)
 		if (!strcmp(part->name, name))
 			return part;
+
 	return NULL;
 }
 
@@ -18,6 +18,7 @@
 #ifndef _NX_EMMC_H_
 #define _NX_EMMC_H_
 
+#include <storage/mbr_gpt.h>
 #include <storage/sdmmc.h>
 #include <libs/fatfs/ff.h>
 #include <utils/types.h>
@@ -42,6 +43,7 @@ extern sdmmc_storage_t emmc_storage;
 extern FATFS emmc_fs;
 
 void nx_emmc_gpt_parse(link_t *gpt, sdmmc_storage_t *storage);
+void nx_emmc_gpt_parse_buf(link_t *gpt, gpt_t *gpt_buf);
 void nx_emmc_gpt_free(link_t *gpt);
 emmc_part_t *nx_emmc_part_find(link_t *gpt, const char *name);
 int  nx_emmc_part_read(sdmmc_storage_t *storage, emmc_part_t *part, u32 sector_off, u32 num_sectors, void *buf);
@@ -33,6 +33,7 @@
 #define BIS_CLUSTER_SIZE      16384
 #define BIS_CACHE_MAX_ENTRIES 16384
 #define BIS_CACHE_LOOKUP_TBL_EMPTY_ENTRY -1
+#define BIS_FLUSH_PACKED_MAX  32
 
 typedef struct _cluster_cache_t
 {
@@ -195,20 +196,63 @@ static void _nx_emmc_bis_cluster_cache_init(bool enable_cache)
 	bis_cache->enabled = enable_cache;
 }
 
-static void _nx_emmc_bis_flush_cache()
+static int _nx_emmc_bis_flush_cache()
 {
 	if (!bis_cache->enabled || !bis_cache->dirty_cnt)
-		return;
+		return 0; // Success.
+
+	int res = 0;
+	u8  tweak[SE_KEY_128_SIZE] __attribute__((aligned(4)));
+	sdmmc_packed_wr_t wr[BIS_FLUSH_PACKED_MAX];
+	u32 wr_cnt = 0;
+	sdmmc_storage_t *storage = !emu_offset ? &emmc_storage : &sd_storage;
+	u32 lba_start = emu_offset + system_part->lba_start;
+	u32 part_sectors = system_part->lba_end - system_part->lba_start + 1;
+	u32 wr_max = MIN(MAX(storage->ext_csd.max_packed_wr, 1), BIS_FLUSH_PACKED_MAX);
 
 	for (u32 i = 0; i < bis_cache->top_idx && bis_cache->dirty_cnt; i++)
 	{
-		if (bis_cache->clusters[i].dirty) {
-			nx_emmc_bis_write_block(bis_cache->clusters[i].cluster_idx * BIS_CLUSTER_SECTORS, BIS_CLUSTER_SECTORS, NULL, true);
-			bis_cache->dirty_cnt--;
+		if (!bis_cache->clusters[i].dirty)
+			continue;
+
+		bis_cache->dirty_cnt--;
+
+		// Check that the cluster is inside the partition.
+		u32 cluster = bis_cache->clusters[i].cluster_idx;
+		if (cluster * BIS_CLUSTER_SECTORS + BIS_CLUSTER_SECTORS > part_sectors)
+		{
+			res = 1; // R/W error.
+			continue;
+		}
+
+		// Encrypt in place, since cache is reset after flushing.
+		if (!_nx_aes_xts_crypt_sec(ks_tweak, ks_crypt, 1, tweak, true, 0, cluster,
+			bis_cache->clusters[i].data, bis_cache->clusters[i].data, BIS_CLUSTER_SIZE))
+		{
+			res = 1; // Encryption error.
+			continue;
+		}
+
+		// Batch clusters into packed writes.
+		wr[wr_cnt].sector = lba_start + cluster * BIS_CLUSTER_SECTORS;
+		wr[wr_cnt].num_sectors = BIS_CLUSTER_SECTORS;
+		wr[wr_cnt].buf = bis_cache->clusters[i].data;
+		wr_cnt++;
+
+		if (wr_cnt == wr_max)
+		{
+			if (!sdmmc_storage_write_packed(storage, wr, wr_cnt))
+				res = 1; // R/W error.
+			wr_cnt = 0;
 		}
 	}
 
+	if (wr_cnt && !sdmmc_storage_write_packed(storage, wr, wr_cnt))
+		res = 1; // R/W error.
+
 	_nx_emmc_bis_cluster_cache_init(true);
+
+	return res;
 }
 
 static int nx_emmc_bis_read_block_normal(u32 sector, u32 count, void *buff)
@@ -272,8 +316,8 @@ static int nx_emmc_bis_read_block_cached(u32 sector, u32 count, void *buff)
 	}
 
 	// Flush cache if full.
-	if (bis_cache->top_idx >= BIS_CACHE_MAX_ENTRIES)
-		_nx_emmc_bis_flush_cache();
+	if (bis_cache->top_idx >= BIS_CACHE_MAX_ENTRIES && _nx_emmc_bis_flush_cache())
+		return 1; // R/W error.
 
 	// Set new cached cluster parameters.
 	bis_cache->clusters[bis_cache->top_idx].cluster_idx = cluster;
@@ -377,8 +421,10 @@ void nx_emmc_bis_init(emmc_part_t *part, bool enable_cache, u32 emummc_offset)
 		system_part = NULL;
 }
 
-void nx_emmc_bis_end()
+int nx_emmc_bis_end()
 {
-	_nx_emmc_bis_flush_cache();
+	int res = _nx_emmc_bis_flush_cache();
 	system_part = NULL;
+
+	return res;
 }
@@ -16,6 +16,7 @@
  */
 
 #include <storage/nx_sd.h>
+#include <libs/compr/lz4c.h>
 #include <storage/sdmmc.h>
 #include <storage/sdmmc_driver.h>
 #include <gfx_utils.h>
@@ -222,6 +223,44 @@ void *sd_file_read(const char *path, u32 *fsize)
 	return buf;
 }
 
+// Reads an LZ4 container as built for nyx.bin and modules. Plain files are read as is.
+void *sd_file_read_lz4c(const char *path, u32 *fsize)
+{
+	FIL fp;
+	lz4c_hdr_t hdr;
+	void *buf;
+
+	if (f_open(&fp, path, FA_READ) != FR_OK)
+		return NULL;
+
+	u32 size = f_size(&fp);
+
+	if (size > sizeof(lz4c_hdr_t) && f_read(&fp, &hdr, sizeof(lz4c_hdr_t), NULL) == FR_OK &&
+		hdr.magic == LZ4C_MAGIC)
+	{
+		size = hdr.size;
+		buf = lz4c_file_read(&fp, &hdr);
+	}
+	else
+	{
+		buf = malloc(size);
+		f_lseek(&fp, 0);
+
+		if (f_read(&fp, buf, size, NULL) != FR_OK)
+		{
+			free(buf);
+			buf = NULL;
+		}
+	}
+
+	f_close(&fp);
+
+	if (buf && fsize)
+		*fsize = size;
+
+	return buf;
+}
+
 int sd_save_to_file(void *buf, u32 size, const char *filename)
 {
 	FIL fp;
@@ -18,18 +18,126 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <sys/stat.h>
 #include "lz.h"
+#include "lze.h"
+#include <libs/compr/lze.h>
+
+// Assumed RCM payload throughput in KB/s. Pass the one measured on your host to -b.
+#define RCM_KBPS_DEFAULT 500
 
 char filename[1024];
 
+static uint32_t _compress(int lze, uint8_t *in, uint8_t *out, uint32_t in_size, uint32_t *work)
+{
+	if (lze)
+		return lze_compress(in, out, in_size);
+
+	return LZ_CompressFast(in, out, in_size, work);
+}
+
+static uint32_t _uncompress(int lze, uint8_t *in, uint8_t *out, uint32_t in_size)
+{
+	if (lze)
+		return lze_uncompress(in, out, in_size);
+
+	return LZ_Uncompress(in, out, in_size);
+}
+
+static double _time_s()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int _benchmark(uint8_t *in_buf, uint32_t in_size, uint32_t *work, uint32_t rcm_kbps)
+{
+	static const char *names[] = { "lz77", "lze" };
+	uint8_t *out_buf[2];
+	uint32_t out_size[2];
+	uint8_t *dec_buf = (uint8_t *)malloc(in_size);
+
+	out_buf[0] = (uint8_t *)malloc(in_size + in_size / 8 + 257);
+	out_buf[1] = (uint8_t *)malloc(in_size + in_size / 8 + 257);
+
+	printf("Input: %d bytes, RCM at %d KB/s\n\n", in_size, rcm_kbps);
+	printf("compr      size  ratio  rcm_ms  compr_ms  dec_MB/s\n");
+
+	for (int lze = 0; lze < 2; lze++)
+	{
+		uint32_t total = 0;
+		uint32_t half[2] = { in_size / 2, in_size - (in_size / 2) };
+
+		// Same two part split as the loader.
+		double t = _time_s();
+		for (int i = 0; i < 2; i++)
+		{
+			out_size[i] = _compress(lze, in_buf + (in_size / 2) * i, out_buf[i], half[i], work);
+			total += out_size[i];
+		}
+		double compr_ms = (_time_s() - t) * 1000;
+
+		// Verify and time decoding.
+		uint32_t runs = 0;
+		t = _time_s();
+		do
+		{
+			uint32_t pos = 0;
+			for (int i = 0; i < 2; i++)
+				pos += _uncompress(lze, out_buf[i], dec_buf + pos, out_size[i]);
+
+			if (pos != in_size || memcmp(dec_buf, in_buf, in_size))
+			{
+				fprintf(stderr, "%s: roundtrip mismatch!\n", names[lze]);
+				return 1;
+			}
+			runs++;
+		} while (_time_s() - t < 0.2);
+		double dec_s = (_time_s() - t) / runs;
+
+		printf("%-5s %9d %5.1f%% %7d %9.0f %9.1f\n", names[lze], total, total * 100.0 / in_size,
+			(uint32_t)(total * 1000ull / (rcm_kbps * 1024)), compr_ms, in_size / dec_s / (1024 * 1024));
+	}
+
+	free(dec_buf);
+	free(out_buf[0]);
+	free(out_buf[1]);
+
+	return 0;
+}
+
 int main(int argc, char *argv[])
 {
 	int nbytes;
 	int filename_len;
+	int lze = 0;
+	int bench = 0;
 	struct stat statbuf;
 	FILE *in_file, *out_file;
 
+	// Options.
+	while (argc > 2 && argv[1][0] == '-')
+	{
+		if (!strcmp(argv[1], "-e"))
+			lze = 1;
+		else if (!strcmp(argv[1], "-b"))
+			bench = 1;
+		else
+			break;
+		argc--;
+		argv++;
+	}
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: lz77 [-e] <file>           Split and compress, -e for LZE.\n");
+		fprintf(stderr, "       lz77 -b <file> [rcm KB/s]  Compare LZ77 and LZE.\n");
+		exit(1);
+	}
+
 	if(stat(argv[1], &statbuf))
 		goto error;
 
@@ -40,9 +148,10 @@ int main(int argc, char *argv[])
 	filename_len = strlen(filename);
 
 	uint32_t in_size = statbuf.st_size;
-	uint8_t *in_buf  = (uint8_t *)malloc(in_size);
+	uint8_t *in_buf  = (uint8_t *)calloc(in_size + 4, 1); // LZ77 match search peeks past the end.
 
-	uint32_t out_size = statbuf.st_size + 257;
+	// LZE worst case is 1 control byte per 8 literals.
+	uint32_t out_size = statbuf.st_size + statbuf.st_size / 8 + 257;
 	uint8_t *out_buf = (uint8_t *)malloc(out_size);
 
 	if(!(in_buf && out_buf))
@@ -54,6 +163,12 @@ int main(int argc, char *argv[])
 	fclose(in_file);
 
 	uint32_t *work = (uint32_t*)malloc(sizeof(uint32_t) * (in_size + 65536));
+	if (!work)
+		goto error;
+
+	if (bench)
+		return _benchmark(in_buf, in_size, work, argc > 2 ? atoi(argv[2]) : RCM_KBPS_DEFAULT);
+
 	for (int i = 0; i < 2; i++)
 	{
 		uint32_t in_size_tmp;
@@ -68,10 +183,7 @@ int main(int argc, char *argv[])
 			strcpy(filename + filename_len, ".01.lz");
 		}
 
-		if (work)
-			nbytes = LZ_CompressFast(in_buf + (in_size / 2) * i, out_buf, in_size_tmp, work);
-		else
-			goto error;
+		nbytes = _compress(lze, in_buf + (in_size / 2) * i, out_buf, in_size_tmp, work);
 
 		if (nbytes > out_size)
 			goto error;
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * LZE compressor. See bdk/libs/compr/lze.h for the stream format.
+ *
+ * Every token has a fixed bit cost, so an optimal parse is a shortest path
+ * over input positions. Matches come from hash chains of 2-byte prefixes,
+ * nearest first. For each length only the nearest offset reaching it is kept,
+ * since it is also the cheapest to code.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lze.h"
+
+#define LZE_MIN_MATCH   2
+#define LZE_CHAIN_DEPTH 4096
+#define LZE_LONG_MATCH  512 // Only the full length is tried for longer matches.
+
+typedef struct _lze_node_t
+{
+	uint32_t cost;
+	uint32_t len;    // 1 for literals.
+	uint32_t offset;
+} lze_node_t;
+
+typedef struct _lze_wr_t
+{
+	uint8_t *out;
+	uint32_t pos;
+	uint32_t bits_pos;
+	uint32_t cnt;
+} lze_wr_t;
+
+static uint32_t _lze_gamma_bits(uint32_t val)
+{
+	uint32_t bits = 1;
+
+	while (val > 1)
+	{
+		bits += 2;
+		val >>= 1;
+	}
+
+	return bits;
+}
+
+static uint32_t _lze_match_cost(uint32_t offset, uint32_t len)
+{
+	return 1 + _lze_gamma_bits(((offset - 1) >> 8) + 1) + 8 + _lze_gamma_bits(len - 1);
+}
+
+static void _lze_putbit(lze_wr_t *wr, uint32_t bit)
+{
+	// Reserve a control byte where the decoder will fetch it.
+	if (!wr->cnt)
+	{
+		wr->bits_pos = wr->pos++;
+		wr->out[wr->bits_pos] = 0;
+		wr->cnt = 8;
+	}
+	wr->cnt--;
+
+	if (bit)
+		wr->out[wr->bits_pos] |= 1 << wr->cnt;
+}
+
+static void _lze_putgamma(lze_wr_t *wr, uint32_t val)
+{
+	int msb = 31;
+
+	while (!(val & (1u << msb)))
+		msb--;
+
+	for (int i = msb - 1; i >= 0; i--)
+	{
+		_lze_putbit(wr, 1);
+		_lze_putbit(wr, (val >> i) & 1);
+	}
+	_lze_putbit(wr, 0);
+}
+
+uint32_t lze_compress(const uint8_t *in, uint8_t *out, uint32_t insize)
+{
+	lze_node_t *node = calloc(insize + 1, sizeof(lze_node_t));
+	int32_t *head = malloc(0x10000 * sizeof(int32_t));
+	int32_t *chain = malloc(insize * sizeof(int32_t));
+
+	for (uint32_t i = 0; i < 0x10000; i++)
+		head[i] = -1;
+
+	for (uint32_t i = 1; i <= insize; i++)
+		node[i].cost = 0xFFFFFFFF;
+
+	// Forward pass. Relax every reachable position from each settled one.
+	for (uint32_t pos = 0; pos < insize; pos++)
+	{
+		uint32_t cost = node[pos].cost;
+
+		if (cost + 9 < node[pos + 1].cost)
+		{
+			node[pos + 1].cost = cost + 9;
+			node[pos + 1].len = 1;
+		}
+
+		if (pos + LZE_MIN_MATCH > insize)
+			continue;
+
+		uint32_t hash = (in[pos] << 8) | in[pos + 1];
+		uint32_t max_len = insize - pos;
+		uint32_t best_len = LZE_MIN_MATCH - 1;
+		uint32_t depth = 0;
+
+		for (int32_t ref = head[hash]; ref >= 0 && depth < LZE_CHAIN_DEPTH; ref = chain[ref], depth++)
+		{
+			// Candidate must beat the longest match so far.
+			if (in[ref + best_len] != in[pos + best_len])
+				continue;
+
+			uint32_t len = 0;
+			while (len < max_len && in[ref + len] == in[pos + len])
+				len++;
+
+			if (len <= best_len)
+				continue;
+
+			uint32_t offset = pos - ref;
+			uint32_t from = best_len + 1;
+			if (len > LZE_LONG_MATCH)
+				from = len > from + LZE_LONG_MATCH ? len : from;
+
+			for (uint32_t l = from; l <= len; l++)
+			{
+				uint32_t c = cost + _lze_match_cost(offset, l);
+				if (c < node[pos + l].cost)
+				{
+					node[pos + l].cost = c;
+					node[pos + l].len = l;
+					node[pos + l].offset = offset;
+				}
+			}
+
+			best_len = len;
+			if (len == max_len)
+				break;
+		}
+
+		chain[pos] = head[hash];
+		head[hash] = pos;
+	}
+
+	// Walk back the cheapest path and reverse it in place.
+	uint32_t pos = insize;
+	while (pos)
+	{
+		uint32_t prev = pos - node[pos].len;
+		node[prev].cost = pos; // Reused as forward link.
+		pos = prev;
+	}
+
+	lze_wr_t wr = { out, 0, 0, 0 };
+	while (pos < insize)
+	{
+		uint32_t next = node[pos].cost;
+		uint32_t len = next - pos;
+
+		if (node[next].len == 1)
+		{
+			_lze_putbit(&wr, 0);
+			out[wr.pos++] = in[pos];
+		}
+		else
+		{
+			uint32_t offset = node[next].offset;
+			_lze_putbit(&wr, 1);
+			_lze_putgamma(&wr, ((offset - 1) >> 8) + 1);
+			out[wr.pos++] = (offset - 1) & 0xFF;
+			_lze_putgamma(&wr, len - 1);
+		}
+
+		pos = next;
+	}
+
+	free(node);
+	free(head);
+	free(chain);
+
+	return wr.pos;
+}
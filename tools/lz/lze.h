@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LZE_COMPR_H_
+#define _LZE_COMPR_H_
+
+#include <stdint.h>
+
+// Output buffer must hold insize + insize / 8 + 1 bytes. Returns the compressed size.
+uint32_t lze_compress(const uint8_t *in, uint8_t *out, uint32_t insize);
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compresses a binary in place into the container read by sd_file_read_lz4c().
+ * Blocks are linked, so each one can match against the previous 64KB. Files
+ * that don't shrink or are already packed are left untouched.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libs/compr/lz4.h>
+#include <libs/compr/lz4c.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc != 2)
+	{
+		printf("Usage: %s <file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *fp = fopen(argv[1], "rb");
+	if (!fp)
+	{
+		printf("Cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	u32 size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	u8 *src = malloc(size);
+	if (fread(src, 1, size, fp) != size)
+	{
+		printf("Cannot read %s\n", argv[1]);
+		return 1;
+	}
+	fclose(fp);
+
+	if (size >= sizeof(u32) && *(u32 *)src == LZ4C_MAGIC)
+	{
+		printf("%s is already packed\n", argv[1]);
+		return 0;
+	}
+
+	if (size > LZ4C_SIZE_MAX)
+	{
+		printf("%s: %d bytes is over the loader limit, kept uncompressed\n", argv[1], size);
+		return 0;
+	}
+
+	lz4c_hdr_t hdr;
+	hdr.magic = LZ4C_MAGIC;
+	hdr.size = size;
+	hdr.blk_size = LZ4C_BLK_MAX;
+	hdr.blk_cnt = (size + LZ4C_BLK_MAX - 1) / LZ4C_BLK_MAX;
+
+	u32 bound = LZ4_COMPRESSBOUND(LZ4C_BLK_MAX);
+	u8 *dst = malloc(sizeof(hdr) + hdr.blk_cnt * (sizeof(u32) + bound));
+	u8 *pdst = dst + sizeof(hdr);
+
+	LZ4_stream_t *lz4_s = LZ4_createStream();
+	for (u32 off = 0; off < size; off += LZ4C_BLK_MAX)
+	{
+		u32 blk = size - off < LZ4C_BLK_MAX ? size - off : LZ4C_BLK_MAX;
+		int csize = LZ4_compress_fast_continue(lz4_s, (const char *)src + off,
+			(char *)pdst + sizeof(u32), blk, bound, 1);
+		if (csize <= 0)
+		{
+			printf("Compression failed at %08X\n", off);
+			return 1;
+		}
+
+		memcpy(pdst, &csize, sizeof(u32));
+		pdst += sizeof(u32) + csize;
+	}
+	LZ4_freeStream(lz4_s);
+
+	memcpy(dst, &hdr, sizeof(hdr));
+	u32 dst_size = pdst - dst;
+
+	if (dst_size >= size)
+	{
+		printf("%s: %d -> %d bytes, kept uncompressed\n", argv[1], size, dst_size);
+		return 0;
+	}
+
+	fp = fopen(argv[1], "wb");
+	if (!fp || fwrite(dst, 1, dst_size, fp) != dst_size)
+	{
+		printf("Cannot write %s\n", argv[1]);
+		return 1;
+	}
+	fclose(fp);
+
+	printf("%s: %d -> %d bytes\n", argv[1], size, dst_size);
+
+	free(src);
+	free(dst);
+
+	return 0;
+}
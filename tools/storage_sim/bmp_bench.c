@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the real Nyx frontend/gui_bmp.c decoder and the previous whole file
+ * decoder on a FatFs RAM disk. Both must produce the same image for bottom-top
+ * and top-bottom BMPs. Then the time per decode of a full screen background is
+ * printed for each. The RAM disk makes reads a memcpy, so only the decoder's own
+ * passes over the image are compared. SD read time is the same for both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libs/fatfs/ff.h>
+#include <libs/fatfs/diskio.h>
+#include "gui.h"
+
+#define SECTOR_SIZE  512
+#define DISK_SECTORS 0x20000 // 64MB.
+#define BMP_W        1280
+#define BMP_H        720
+#define ITERS        200
+
+static u8 *disk;
+static int failed;
+
+/*
+ * RAM disk and FatFs glue.
+ */
+
+DSTATUS disk_status(BYTE pdrv)
+{
+	(void)pdrv;
+
+	return 0;
+}
+
+DSTATUS disk_initialize(BYTE pdrv)
+{
+	(void)pdrv;
+
+	return 0;
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+	if (pdrv != DRIVE_SD || sector + count > DISK_SECTORS)
+		return RES_PARERR;
+
+	memcpy(buff, disk + (size_t)sector * SECTOR_SIZE, (size_t)count * SECTOR_SIZE);
+
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+	if (pdrv != DRIVE_SD || sector + count > DISK_SECTORS)
+		return RES_PARERR;
+
+	memcpy(disk + (size_t)sector * SECTOR_SIZE, buff, (size_t)count * SECTOR_SIZE);
+
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+	DWORD *buf = (DWORD *)buff;
+
+	if (pdrv != DRIVE_SD)
+		return RES_PARERR;
+
+	switch (cmd)
+	{
+	case GET_SECTOR_COUNT:
+		*buf = DISK_SECTORS;
+		break;
+	case GET_BLOCK_SIZE:
+		*buf = 1;
+		break;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_set_info(BYTE pdrv, BYTE cmd, void *buff)
+{
+	(void)pdrv;
+	(void)cmd;
+	(void)buff;
+
+	return RES_OK;
+}
+
+void *ff_memalloc(UINT msize)
+{
+	return malloc(msize);
+}
+
+void ff_memfree(void *mblock)
+{
+	free(mblock);
+}
+
+DWORD get_fattime(void)
+{
+	return ((DWORD)(2026 - 1980) << 25) | (1 << 21) | (1 << 16);
+}
+
+// FatFs error printing.
+void gfx_printf(const char *fmt, ...)
+{
+	(void)fmt;
+}
+
+/*
+ * Previous decoder. Reads the whole file, copies the pixel data to a
+ * temporary buffer and copies it back pixel by pixel.
+ */
+
+static void *_file_read(const char *path, u32 *fsize)
+{
+	FIL fp;
+	if (f_open(&fp, path, FA_READ) != FR_OK)
+		return NULL;
+
+	u32 size = f_size(&fp);
+	if (fsize)
+		*fsize = size;
+
+	void *buf = malloc(size);
+
+	if (f_read(&fp, buf, size, NULL) != FR_OK)
+	{
+		free(buf);
+		f_close(&fp);
+
+		return NULL;
+	}
+
+	f_close(&fp);
+
+	return buf;
+}
+
+static lv_img_dsc_t *_bmp_decode_old(const char *path)
+{
+	u32 fsize;
+	u8 *bitmap = _file_read(path, &fsize);
+	if (!bitmap)
+		return NULL;
+
+	u32 size = bitmap[2] | bitmap[3] << 8 | bitmap[4] << 16 | bitmap[5] << 24;
+	u32 offset = bitmap[10] | bitmap[11] << 8 | bitmap[12] << 16 | bitmap[13] << 24;
+	u32 size_x = bitmap[18] | bitmap[19] << 8 | bitmap[20] << 16 | bitmap[21] << 24;
+	u32 size_y = bitmap[22] | bitmap[23] << 8 | bitmap[24] << 16 | bitmap[25] << 24;
+
+	if (bitmap[0] != 'B' || bitmap[1] != 'M' || bitmap[28] != 32 || size > fsize)
+	{
+		free(bitmap);
+		return NULL;
+	}
+
+	bool flipped = false;
+	if (size_y & 0x80000000)
+	{
+		size_y = ~size_y + 1;
+		flipped = true;
+	}
+
+	lv_img_dsc_t *img_desc = (lv_img_dsc_t *)bitmap;
+	u8 *offset_copy = (u8 *)ALIGN((uintptr_t)bitmap + sizeof(lv_img_dsc_t), 0x10);
+
+	img_desc->header.always_zero = 0;
+	img_desc->header.w = size_x;
+	img_desc->header.h = size_y;
+	img_desc->header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+	img_desc->data_size = size - offset;
+	img_desc->data = offset_copy;
+
+	u32 *tmp = malloc(size);
+	u32 *tmp2 = (u32 *)offset_copy;
+
+	memcpy((u8 *)tmp, bitmap + offset, img_desc->data_size);
+	u32 j = 0;
+
+	for (u32 y = 0; y < size_y; y++)
+	{
+		u32 src_y = flipped ? y : size_y - 1 - y;
+		for (u32 x = 0; x < size_x; x++)
+			tmp2[j++] = tmp[src_y * size_x + x];
+	}
+
+	free(tmp);
+
+	return img_desc;
+}
+
+/*
+ * Benchmark.
+ */
+
+static void _check(bool ok, const char *name)
+{
+	printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+	if (!ok)
+		failed++;
+}
+
+static void _put32(u8 *p, u32 val)
+{
+	p[0] = val;
+	p[1] = val >> 8;
+	p[2] = val >> 16;
+	p[3] = val >> 24;
+}
+
+static bool _bmp_write(const char *path, bool top_bottom)
+{
+	FIL fp;
+	UINT bw;
+	u32 data_size = BMP_W * BMP_H * sizeof(u32);
+	u32 size = 0x36 + data_size;
+	u8 *bmp = calloc(1, size);
+
+	bmp[0] = 'B';
+	bmp[1] = 'M';
+	_put32(bmp + 2, size);
+	_put32(bmp + 10, 0x36);
+	_put32(bmp + 14, 40);
+	_put32(bmp + 18, BMP_W);
+	_put32(bmp + 22, top_bottom ? (u32)-BMP_H : BMP_H);
+	bmp[26] = 1;
+	bmp[28] = 32;
+	_put32(bmp + 34, data_size);
+
+	u32 *px = (u32 *)(bmp + 0x36);
+	for (u32 i = 0; i < BMP_W * BMP_H; i++)
+		px[i] = i * 0x9E3779B9;
+
+	bool ok = !f_open(&fp, path, FA_CREATE_ALWAYS | FA_WRITE) &&
+		!f_write(&fp, bmp, size, &bw) && bw == size;
+	f_close(&fp);
+	free(bmp);
+
+	return ok;
+}
+
+static bool _img_equal(const lv_img_dsc_t *a, const lv_img_dsc_t *b)
+{
+	return a && b && a->header.w == b->header.w && a->header.h == b->header.h &&
+		a->header.w == BMP_W && a->header.h == BMP_H &&
+		!memcmp(a->data, b->data, BMP_W * BMP_H * sizeof(u32));
+}
+
+static double _bench(lv_img_dsc_t *(*decode)(const char *), const char *path)
+{
+	struct timespec t0, t1;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (u32 i = 0; i < ITERS; i++)
+		free(decode(path));
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	return ((t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6) / ITERS;
+}
+
+int main()
+{
+	FATFS fs;
+	u8 *work = malloc(0x10000);
+	static const char *paths[2] = { "bottom_top.bmp", "top_bottom.bmp" };
+
+	disk = calloc(DISK_SECTORS, SECTOR_SIZE);
+	if (f_mkfs("", FM_FAT32, 512, work, 0x10000) || f_mount(&fs, "", 1) ||
+		!_bmp_write(paths[0], false) || !_bmp_write(paths[1], true))
+	{
+		printf("RAM disk setup failed\n");
+		return 1;
+	}
+	free(work);
+
+	for (u32 i = 0; i < 2; i++)
+	{
+		lv_img_dsc_t *old_img = _bmp_decode_old(paths[i]);
+		lv_img_dsc_t *new_img = bmp_to_lvimg_obj(paths[i]);
+
+		char name[64];
+		sprintf(name, "%s decodes the same", paths[i]);
+		_check(_img_equal(old_img, new_img), name);
+
+		free(old_img);
+		free(new_img);
+	}
+
+	if (!failed)
+	{
+		printf("\n%dx%d, %d decodes each, ms per decode:\n", BMP_W, BMP_H, ITERS);
+		printf("%-16s %8s %8s %8s\n", "file", "old", "new", "speedup");
+		for (u32 i = 0; i < 2; i++)
+		{
+			double t_old = _bench(_bmp_decode_old, paths[i]);
+			double t_new = _bench(bmp_to_lvimg_obj, paths[i]);
+			printf("%-16s %8.3f %8.3f %7.2fx\n", paths[i], t_old, t_new, t_old / t_new);
+		}
+		printf("\n");
+	}
+
+	f_mount(NULL, "", 0);
+	free(disk);
+
+	printf("%s\n", failed ? "FAILED" : "OK");
+
+	return failed ? 1 : 0;
+}
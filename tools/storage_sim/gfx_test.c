@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the real bootloader/gfx/gfx.c console on a host framebuffer. The same
+ * random console script is drawn immediately and deferred, with flushes at
+ * random points and enough output to overflow the defer buffer, and both
+ * framebuffers must match bit for bit. Text runs are also checked against a
+ * per pixel reference renderer, in both font sizes and with and without
+ * background fill.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gfx.h"
+
+#define FB_W     720
+#define FB_H     1280
+#define FB_PX    (FB_W * FB_H)
+#define SCRIPTS  64
+#define OPS      4000
+
+static u32 *fb_ref;
+static u8 font[95][8];
+static int failed;
+
+/*
+ * Deterministic script generator.
+ */
+
+static u32 rng;
+
+static u32 _rand()
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+
+	return rng;
+}
+
+static u32 _rand_col()
+{
+	static const u32 cols[] = { 0xFFCCCCCC, 0xFF1B1B1B, 0xFF00DDFF, 0xFFFF0000, 0xFF96FF00 };
+
+	// Reuse colors often, so runs get merged.
+	return (_rand() & 1) ? cols[_rand() % 5] : _rand();
+}
+
+// Printable text that fits the rest of the current line.
+static void _rand_text(char *buf)
+{
+	u32 fntsz = (gfx_con.fntsz == 16) ? 16 : 8;
+	u32 room = (FB_W - gfx_con.x) / fntsz;
+	u32 len = room ? _rand() % (MIN(room, 40) + 1) : 0;
+
+	for (u32 i = 0; i < len; i++)
+		buf[i] = 32 + _rand() % 95;
+	buf[len] = 0;
+}
+
+static void _fb_fill(u32 *fb, u32 seed)
+{
+	for (u32 i = 0; i < FB_PX; i++)
+		fb[i] = seed * 0x9E3779B9 + i * 0x85EBCA6B;
+}
+
+/*
+ * Per pixel reference renderer.
+ */
+
+static void _ref_putc(char c)
+{
+	u32 scale = (gfx_con.fntsz == 16) ? 2 : 1;
+
+	if (c < 32 || c > 126)
+		return;
+
+	for (u32 i = 0; i < 8 * scale; i++)
+	{
+		u8 v = font[c - 32][i / scale];
+		u32 *fb = fb_ref + gfx_con.x + (gfx_con.y + i) * FB_W;
+
+		for (u32 j = 0; j < 8 * scale; j++)
+		{
+			if (v & BIT(j / scale))
+				fb[j] = gfx_con.fgcol;
+			else if (gfx_con.fillbg)
+				fb[j] = gfx_con.bgcol;
+		}
+	}
+}
+
+// Reads each glyph back from an opaque 8px render.
+static void _font_extract(u32 *fb)
+{
+	gfx_init_ctxt(fb, FB_W, FB_H, FB_W);
+	gfx_con_init();
+	gfx_con.fntsz = 8;
+	gfx_con_setcol(1, 1, 0);
+
+	for (u32 c = 0; c < 95; c++)
+	{
+		gfx_con_setpos(0, 0);
+		gfx_putc(32 + c);
+
+		for (u32 i = 0; i < 8; i++)
+		{
+			font[c][i] = 0;
+			for (u32 j = 0; j < 8; j++)
+				font[c][i] |= fb[i * FB_W + j] ? BIT(j) : 0;
+		}
+	}
+}
+
+/*
+ * Tests.
+ */
+
+static void _check(bool ok, const char *name)
+{
+	printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+	if (!ok)
+		failed++;
+}
+
+// Draws a random console script. Deferred output is flushed at random points.
+static void _run_script(u32 *fb, u32 seed, bool defer)
+{
+	char text[64];
+
+	rng = seed;
+	_fb_fill(fb, seed);
+	gfx_init_ctxt(fb, FB_W, FB_H, FB_W);
+	gfx_con_init();
+	gfx_con_defer(defer);
+
+	for (u32 op = 0; op < OPS; op++)
+	{
+		switch (_rand() % 9)
+		{
+		case 0:
+			gfx_con_setcol(_rand_col(), _rand() & 1, _rand_col());
+			break;
+		case 1:
+			gfx_con.fntsz = (_rand() & 1) ? 16 : 8;
+			gfx_con_setpos(_rand() % (FB_W - 16), _rand() % (FB_H - 16));
+			break;
+		case 2:
+			gfx_puts("\n");
+			break;
+		case 3:
+			_rand_text(text);
+			gfx_putc(text[0] ? text[0] : '\n');
+			break;
+		case 4:
+			_rand_text(text);
+			if (strlen(text) > 4)
+			{
+				text[strlen(text) / 2] = 0;
+				gfx_printf("%k%s%%%k", _rand_col(), text, _rand_col());
+			}
+			break;
+		case 5:
+			if (FB_W - gfx_con.x >= 24 * 16)
+				gfx_printf("%d %08X %K%c", _rand(), _rand(), _rand_col(), 'A' + _rand() % 26);
+			break;
+		case 6:
+			// Keep the random sequence the same in both modes.
+			if (!(_rand() % 64) && defer)
+				gfx_con_flush();
+			break;
+		default:
+			_rand_text(text);
+			gfx_puts(text);
+			break;
+		}
+	}
+
+	gfx_con_defer(false);
+}
+
+// Same text through gfx_puts runs and through the reference renderer.
+static void _run_ref(u32 *fb, u32 seed)
+{
+	char text[64];
+
+	rng = seed;
+	_fb_fill(fb, seed);
+	_fb_fill(fb_ref, seed);
+	gfx_init_ctxt(fb, FB_W, FB_H, FB_W);
+	gfx_con_init();
+
+	for (u32 op = 0; op < OPS; op++)
+	{
+		switch (_rand() % 4)
+		{
+		case 0:
+			gfx_con_setcol(_rand_col(), _rand() & 1, _rand_col());
+			break;
+		case 1:
+			gfx_con.fntsz = (_rand() & 1) ? 16 : 8;
+			gfx_con_setpos(_rand() % (FB_W - 16), _rand() % (FB_H - 16));
+			break;
+		default:
+			_rand_text(text);
+
+			u32 x = gfx_con.x;
+			for (u32 i = 0; text[i]; i++)
+			{
+				_ref_putc(text[i]);
+				gfx_con.x += (gfx_con.fntsz == 16) ? 16 : 8;
+			}
+			gfx_con.x = x;
+
+			gfx_puts(text);
+			break;
+		}
+	}
+}
+
+int main()
+{
+	u32 *fb_imm = malloc(FB_PX * sizeof(u32));
+	u32 *fb_def = malloc(FB_PX * sizeof(u32));
+	fb_ref = malloc(FB_PX * sizeof(u32));
+
+	_font_extract(fb_imm);
+
+	bool ok = true;
+	for (u32 seed = 1; seed <= SCRIPTS && ok; seed++)
+	{
+		_run_script(fb_imm, seed, false);
+		_run_script(fb_def, seed, true);
+		ok = !memcmp(fb_imm, fb_def, FB_PX * sizeof(u32));
+		if (!ok)
+			printf("script %d differs\n", seed);
+	}
+	_check(ok, "deferred output matches immediate output");
+
+	ok = true;
+	for (u32 seed = 1; seed <= SCRIPTS && ok; seed++)
+	{
+		_run_ref(fb_imm, seed);
+		ok = !memcmp(fb_imm, fb_ref, FB_PX * sizeof(u32));
+		if (!ok)
+			printf("script %d differs\n", seed);
+	}
+	_check(ok, "text runs match the per pixel renderer");
+
+	free(fb_imm);
+	free(fb_def);
+	free(fb_ref);
+
+	printf("%s\n", failed ? "FAILED" : "OK");
+
+	return failed ? 1 : 0;
+}
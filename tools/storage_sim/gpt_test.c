@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the real storage/nx_emmc.c (bootloader, or Nyx with GPT_TEST_NYX)
+ * against GPT images. Every parsed list and every nx_emmc_part_find() result
+ * is compared with a linear decode of the image. Also checks the parse cache
+ * and its invalidation, hand-built lists, reused list heads and running out
+ * of index slots.
+ *
+ * Without arguments, built-in NX layouts are used. Otherwise each argument is
+ * an image that starts at LBA 0, like a rawnand.bin dump. Only its first
+ * 34 sectors are read.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nx_emmc.h"
+#include <storage/mbr_gpt.h>
+#include <utils/list.h>
+#include <utils/util.h>
+
+#define GPT_SECTORS (NX_GPT_FIRST_LBA + NX_GPT_NUM_BLOCKS)
+#define HEADS_MAX   12 // More than the parser index slots.
+
+static u8 img[GPT_SECTORS * NX_EMMC_BLOCKSIZE] __attribute__((aligned(8)));
+static gpt_t *img_gpt = (gpt_t *)(img + NX_GPT_FIRST_LBA * NX_EMMC_BLOCKSIZE);
+static u32 rd_sectors;
+static int failed;
+
+/*
+ * Storage glue.
+ */
+
+static int _img_read(u32 sector, u32 num_sectors, void *buf)
+{
+	if (sector + num_sectors > GPT_SECTORS)
+		return 0;
+
+	memcpy(buf, img + sector * NX_EMMC_BLOCKSIZE, num_sectors * NX_EMMC_BLOCKSIZE);
+	rd_sectors += num_sectors;
+
+	return 1;
+}
+
+int emummc_storage_read(u32 sector, u32 num_sectors, void *buf)
+{
+	return _img_read(sector, num_sectors, buf);
+}
+
+int emummc_storage_write(u32 sector, u32 num_sectors, void *buf)
+{
+	(void)sector;
+	(void)num_sectors;
+	(void)buf;
+
+	return 0;
+}
+
+int sdmmc_storage_read(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf)
+{
+	(void)storage;
+
+	return _img_read(sector, num_sectors, buf);
+}
+
+int sdmmc_storage_write(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf)
+{
+	(void)storage;
+	(void)sector;
+	(void)num_sectors;
+	(void)buf;
+
+	return 0;
+}
+
+u32 fuse_read_hw_state()
+{
+	return 0;
+}
+
+/*
+ * GPT images.
+ */
+
+typedef struct _layout_part_t
+{
+	u32 slot;
+	const char *name;
+	u32 sectors;
+} layout_part_t;
+
+// Stock 32GB layout.
+static const layout_part_t nx_layout[] = {
+	{ 0,  "PRODINFO",               0x3FBC },
+	{ 1,  "PRODINFOF",              0x4000 },
+	{ 2,  "BCPKG2-1-Normal-Main",   0x4000 },
+	{ 3,  "BCPKG2-2-Normal-Sub",    0x4000 },
+	{ 4,  "BCPKG2-3-SafeMode-Main", 0x4000 },
+	{ 5,  "BCPKG2-4-SafeMode-Sub",  0x4000 },
+	{ 6,  "BCPKG2-5-Repair-Main",   0x4000 },
+	{ 7,  "BCPKG2-6-Repair-Sub",    0x4000 },
+	{ 8,  "SAFE",                   0x20000 },
+	{ 9,  "SYSTEM",                 0x500000 },
+	{ 10, "USER",                   0x3400000 },
+	{ 0,  NULL, 0 }
+};
+
+// Sparse slots, unsorted and duplicate names and a name that gets truncated.
+static const layout_part_t odd_layout[] = {
+	{ 0,   "USER",                                  0x1000 },
+	{ 1,   "SYSTEM",                                0x1000 },
+	{ 5,   "PRODINFO",                              0x1000 },
+	{ 6,   "SYSTEM",                                0x1000 },
+	{ 7,   "A",                                     0x1000 },
+	{ 8,   "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAXX", 0x1000 },
+	{ 64,  "BCPKG2-1-Normal-Main",                  0x1000 },
+	{ 127, "Z",                                     0x1000 },
+	{ 0,   NULL, 0 }
+};
+
+static void _gpt_fix_crc()
+{
+	gpt_header_t *hdr = &img_gpt->header;
+
+	hdr->part_ents_crc32 = crc32_calc(0, (const u8 *)img_gpt->entries, sizeof(gpt_entry_t) * hdr->num_part_ents);
+	hdr->crc32 = 0;
+	hdr->crc32 = crc32_calc(0, (const u8 *)hdr, hdr->size);
+}
+
+static void _gpt_build(const layout_part_t *layout)
+{
+	gpt_header_t *hdr = &img_gpt->header;
+	u64 lba = GPT_SECTORS;
+
+	memset(img, 0, sizeof(img));
+	memcpy(&hdr->signature, "EFI PART", 8);
+	hdr->revision = 0x10000;
+	hdr->size = 92;
+	hdr->my_lba = NX_GPT_FIRST_LBA;
+	hdr->first_use_lba = GPT_SECTORS;
+	hdr->part_ent_lba = NX_GPT_FIRST_LBA + 1;
+	hdr->num_part_ents = 128;
+	hdr->part_ent_size = sizeof(gpt_entry_t);
+
+	for (u32 i = 0; layout[i].name; i++)
+	{
+		gpt_entry_t *ent = &img_gpt->entries[layout[i].slot];
+
+		ent->lba_start = lba;
+		ent->lba_end = lba + layout[i].sectors - 1;
+		ent->attrs = (u64)i << 48;
+		for (u32 j = 0; j < 36 && layout[i].name[j]; j++)
+			ent->name[j] = layout[i].name[j];
+
+		lba += layout[i].sectors;
+	}
+
+	hdr->last_use_lba = lba + 32;
+	hdr->alt_lba = lba + 33;
+	_gpt_fix_crc();
+}
+
+static bool _gpt_load(const char *path)
+{
+	FILE *fp = fopen(path, "rb");
+	if (!fp)
+		return false;
+
+	memset(img, 0, sizeof(img));
+	bool res = fread(img, 1, sizeof(img), fp) == sizeof(img);
+	fclose(fp);
+
+	return res;
+}
+
+/*
+ * Checks.
+ */
+
+static void _check(bool ok, const char *what, const char *name)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s: %s\n", what, name);
+		failed++;
+	}
+}
+
+static bool _ref_used(u32 i)
+{
+	return img_gpt->entries[i].lba_start >= img_gpt->header.first_use_lba;
+}
+
+static void _ref_name(u32 i, char *name)
+{
+	for (u32 j = 0; j < 36; j++)
+		name[j] = img_gpt->entries[i].name[j];
+	name[35] = 0;
+}
+
+// Compares a parsed list with a linear decode of the image GPT.
+static void _check_list(link_t *gpt, const char *what)
+{
+	char name[37];
+	u32 num_parts = 0;
+	link_t *iter = gpt->next;
+
+	for (u32 i = 0; i < img_gpt->header.num_part_ents; i++)
+	{
+		if (!_ref_used(i))
+			continue;
+
+		num_parts++;
+		if (iter == gpt)
+			break;
+
+		emmc_part_t *part = CONTAINER_OF(iter, emmc_part_t, link);
+		_ref_name(i, name);
+		_check(part->index == i && part->lba_start == img_gpt->entries[i].lba_start &&
+			part->lba_end == img_gpt->entries[i].lba_end && part->attrs == img_gpt->entries[i].attrs &&
+			!strcmp(part->name, name), what, "part mismatch");
+
+		// Lookups must return the first part with that name in GPT order.
+		emmc_part_t *first = NULL;
+		LIST_FOREACH_ENTRY(emmc_part_t, p, gpt, link)
+		{
+			if (!strcmp(p->name, name))
+			{
+				first = p;
+				break;
+			}
+		}
+		_check(nx_emmc_part_find(gpt, name) == first, what, name);
+
+		iter = iter->next;
+	}
+
+	u32 listed = 0;
+	LIST_FOREACH(it, gpt)
+		listed++;
+
+	_check(listed == num_parts, what, "part count");
+	_check(!nx_emmc_part_find(gpt, "NOT-A-PARTITION"), what, "missing name found");
+	_check(!nx_emmc_part_find(gpt, "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAXX"), what, "untruncated name found");
+}
+
+static void _test_image(const char *what)
+{
+	link_t gpt, gpt2;
+	bool crc_valid;
+
+	// Is this table cacheable?
+	{
+		gpt_header_t hdr;
+		memcpy(&hdr, &img_gpt->header, sizeof(gpt_header_t));
+		hdr.crc32 = 0;
+		crc_valid = hdr.size >= 92 && hdr.size <= sizeof(gpt_header_t) && hdr.num_part_ents <= 128 &&
+			crc32_calc(0, (const u8 *)&hdr, hdr.size) == img_gpt->header.crc32 &&
+			crc32_calc(0, (const u8 *)img_gpt->entries, sizeof(gpt_entry_t) * hdr.num_part_ents) == hdr.part_ents_crc32;
+	}
+
+	printf("%s: %s GPT\n", what, crc_valid ? "valid" : "unverified");
+
+	// First parse and a cached one. Both lists must be live at the same time.
+	list_init(&gpt);
+	nx_emmc_gpt_parse(&gpt, &emmc_storage);
+	_check_list(&gpt, what);
+
+	rd_sectors = 0;
+	list_init(&gpt2);
+	nx_emmc_gpt_parse(&gpt2, &emmc_storage);
+	_check_list(&gpt2, what);
+	_check(!crc_valid || rd_sectors == 1, what, "cached parse read the entries");
+
+	nx_emmc_gpt_free(&gpt);
+	_check_list(&gpt2, what);
+	nx_emmc_gpt_free(&gpt2);
+
+	if (!crc_valid)
+		return;
+
+	// A changed table must be parsed again.
+	u32 last = 0;
+	for (u32 i = 0; i < img_gpt->header.num_part_ents; i++)
+		if (_ref_used(i))
+			last = i;
+
+	u8 backup[sizeof(img)];
+	memcpy(backup, img, sizeof(img));
+
+	img_gpt->entries[last].lba_end--;
+	_gpt_fix_crc();
+	rd_sectors = 0;
+	list_init(&gpt);
+	nx_emmc_gpt_parse(&gpt, &emmc_storage);
+	_check(rd_sectors == NX_GPT_NUM_BLOCKS, what, "changed table not read");
+	_check_list(&gpt, what);
+	nx_emmc_gpt_free(&gpt);
+
+	// Entries that don't match their CRC still parse, but never get cached.
+	img_gpt->entries[last].name[0] ^= 0x20;
+	img_gpt->header.part_ents_crc32 ^= 1;
+	img_gpt->header.crc32 = 0;
+	img_gpt->header.crc32 = crc32_calc(0, (const u8 *)&img_gpt->header, img_gpt->header.size);
+	for (u32 i = 0; i < 2; i++)
+	{
+		rd_sectors = 0;
+		list_init(&gpt);
+		nx_emmc_gpt_parse(&gpt, &emmc_storage);
+		_check(rd_sectors == NX_GPT_NUM_BLOCKS, what, "bad CRC table cached");
+		_check_list(&gpt, what);
+		nx_emmc_gpt_free(&gpt);
+	}
+
+	memcpy(img, backup, sizeof(img));
+
+	// Running out of index slots.
+	link_t heads[HEADS_MAX];
+	for (u32 i = 0; i < HEADS_MAX; i++)
+	{
+		list_init(&heads[i]);
+		nx_emmc_gpt_parse(&heads[i], &emmc_storage);
+	}
+	for (u32 i = 0; i < HEADS_MAX; i++)
+		_check_list(&heads[i], what);
+	for (u32 i = 0; i < HEADS_MAX; i++)
+		nx_emmc_gpt_free(&heads[i]);
+}
+
+static void _test_hand_built()
+{
+	link_t gpt;
+	const char *what = "hand-built";
+
+	// Stack part, like the emuMMC tools build. Must not be treated as parsed.
+	emmc_part_t user_part = {0};
+	user_part.lba_end = 0x1000;
+	strcpy(user_part.name, "USER");
+
+	list_init(&gpt);
+	list_append(&gpt, &user_part.link);
+	_check(nx_emmc_part_find(&gpt, "USER") == &user_part, what, "USER");
+	_check(!nx_emmc_part_find(&gpt, "SYSTEM"), what, "SYSTEM");
+
+	// A parsed head that gets reused without a free.
+	_gpt_build(nx_layout);
+	list_init(&gpt);
+	nx_emmc_gpt_parse(&gpt, &emmc_storage);
+	list_init(&gpt);
+	list_append(&gpt, &user_part.link);
+	_check(nx_emmc_part_find(&gpt, "USER") == &user_part, what, "reused head USER");
+	_check(!nx_emmc_part_find(&gpt, "SYSTEM"), what, "reused head SYSTEM");
+
+	// Malloc'd parts are freed one by one.
+	emmc_part_t *part = (emmc_part_t *)calloc(1, sizeof(emmc_part_t));
+	strcpy(part->name, "SAFE");
+	list_init(&gpt);
+	list_append(&gpt, &part->link);
+	_check(nx_emmc_part_find(&gpt, "SAFE") == part, what, "SAFE");
+	nx_emmc_gpt_free(&gpt);
+}
+
+#ifdef GPT_TEST_NYX
+static void _test_parse_buf(const char *what)
+{
+	link_t gpt;
+
+	list_init(&gpt);
+	nx_emmc_gpt_parse_buf(&gpt, img_gpt);
+	_check_list(&gpt, what);
+	nx_emmc_gpt_free(&gpt);
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			if (!_gpt_load(argv[i]))
+			{
+				printf("Cannot read %s\n", argv[i]);
+				return 1;
+			}
+
+			if (memcmp(&img_gpt->header.signature, "EFI PART", 8) || img_gpt->header.num_part_ents > 128)
+			{
+				printf("%s: no GPT\n", argv[i]);
+				failed++;
+				continue;
+			}
+
+			_test_image(argv[i]);
+#ifdef GPT_TEST_NYX
+			_test_parse_buf(argv[i]);
+#endif
+		}
+	}
+	else
+	{
+		_gpt_build(nx_layout);
+		_test_image("nx layout");
+#ifdef GPT_TEST_NYX
+		_test_parse_buf("nx layout");
+#endif
+
+		_gpt_build(odd_layout);
+		_test_image("odd layout");
+#ifdef GPT_TEST_NYX
+		_test_parse_buf("odd layout");
+#endif
+	}
+
+	_test_hand_built();
+
+	printf("%s\n", failed ? "FAILED" : "OK");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the real bdk/mem/minerva_cache.c and FatFs on a RAM disk. Checks the
+ * save/load round trip, that every key field and the console ECID are
+ * enforced, that corrupt or truncated files are rejected and that the cache
+ * expires after MTC_CACHE_MAX_AGE loads.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libs/fatfs/ff.h>
+#include <libs/fatfs/diskio.h>
+#include <mem/minerva_cache.h>
+
+#define SECTOR_SIZE  512
+#define DISK_SECTORS 0x20000 // 64MB.
+#define ENTRIES      10
+
+static u8 *disk;
+static int failed;
+
+/*
+ * RAM disk and FatFs glue.
+ */
+
+DSTATUS disk_status(BYTE pdrv)
+{
+	(void)pdrv;
+
+	return 0;
+}
+
+DSTATUS disk_initialize(BYTE pdrv)
+{
+	(void)pdrv;
+
+	return 0;
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+	if (pdrv != DRIVE_SD || sector + count > DISK_SECTORS)
+		return RES_PARERR;
+
+	memcpy(buff, disk + (size_t)sector * SECTOR_SIZE, (size_t)count * SECTOR_SIZE);
+
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+	if (pdrv != DRIVE_SD || sector + count > DISK_SECTORS)
+		return RES_PARERR;
+
+	memcpy(disk + (size_t)sector * SECTOR_SIZE, buff, (size_t)count * SECTOR_SIZE);
+
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+	DWORD *buf = (DWORD *)buff;
+
+	if (pdrv != DRIVE_SD)
+		return RES_PARERR;
+
+	switch (cmd)
+	{
+	case GET_SECTOR_COUNT:
+		*buf = DISK_SECTORS;
+		break;
+	case GET_BLOCK_SIZE:
+		*buf = 1;
+		break;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_set_info(BYTE pdrv, BYTE cmd, void *buff)
+{
+	(void)pdrv;
+	(void)cmd;
+	(void)buff;
+
+	return RES_OK;
+}
+
+void *ff_memalloc(UINT msize)
+{
+	return malloc(msize);
+}
+
+void ff_memfree(void *mblock)
+{
+	free(mblock);
+}
+
+DWORD get_fattime(void)
+{
+	return ((DWORD)(2026 - 1980) << 25) | (1 << 21) | (1 << 16);
+}
+
+// FatFs error printing.
+void gfx_printf(const char *fmt, ...)
+{
+	(void)fmt;
+}
+
+/*
+ * Tests.
+ */
+
+static const u32 ecid[4] = { 0x12345678, 0x0ABCDEF0, 0x00002A13, 0x0002C0A5 };
+
+static void _check(bool ok, const char *name)
+{
+	printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+	if (!ok)
+		failed++;
+}
+
+static void _key(mtc_cache_hdr_t *key)
+{
+	minerva_cache_key_init(key, 4, 0x21, ecid, 0xCAFEBABE, ENTRIES);
+}
+
+static void _fill(emc_table_t *table, u8 seed)
+{
+	u8 *p = (u8 *)table;
+	for (u32 i = 0; i < ENTRIES * sizeof(emc_table_t); i++)
+		p[i] = (u8)(i * 31 + seed);
+}
+
+static bool _patch(u32 offset, const void *data, u32 size)
+{
+	FIL fp;
+	UINT bw;
+
+	if (f_open(&fp, MTC_CACHE_PATH, FA_READ | FA_WRITE))
+		return false;
+
+	bool ok = !f_lseek(&fp, offset) && !f_write(&fp, data, size, &bw) && bw == size;
+	f_close(&fp);
+
+	return ok;
+}
+
+static bool _truncate(u32 size)
+{
+	FIL fp;
+
+	if (f_open(&fp, MTC_CACHE_PATH, FA_READ | FA_WRITE))
+		return false;
+
+	bool ok = !f_lseek(&fp, size) && !f_truncate(&fp);
+	f_close(&fp);
+
+	return ok;
+}
+
+static u32 _age()
+{
+	FIL fp;
+	UINT br;
+	mtc_cache_hdr_t hdr;
+
+	if (f_open(&fp, MTC_CACHE_PATH, FA_READ))
+		return ~0;
+
+	if (f_read(&fp, &hdr, sizeof(hdr), &br) || br != sizeof(hdr))
+		hdr.age = ~0;
+	f_close(&fp);
+
+	return hdr.age;
+}
+
+int main()
+{
+	FATFS fs;
+	mtc_cache_hdr_t key, other;
+	u32 size = ENTRIES * sizeof(emc_table_t);
+	emc_table_t *trained = malloc(size);
+	emc_table_t *table = malloc(size);
+	u8 *work = malloc(0x10000);
+
+	disk = calloc(DISK_SECTORS, SECTOR_SIZE);
+	if (f_mkfs("", FM_FAT32, 512, work, 0x10000) || f_mount(&fs, "", 1) ||
+		f_mkdir("bootloader") || f_mkdir("bootloader/sys"))
+	{
+		printf("RAM disk setup failed\n");
+		return 1;
+	}
+	free(work);
+
+	// The file format is fixed. The key is everything before crc.
+	_check(sizeof(mtc_cache_hdr_t) == 0x2C && offsetof(mtc_cache_hdr_t, crc) == 0x24 &&
+		offsetof(mtc_cache_hdr_t, ecid) == 0xC, "header layout");
+
+	_key(&key);
+	_fill(trained, 1);
+
+	_fill(table, 0);
+	_check(!minerva_cache_load(&key, table), "missing file is rejected");
+
+	_check(minerva_cache_save(&key, trained), "save");
+	_check(minerva_cache_load(&key, table) && !memcmp(table, trained, size), "round trip");
+	_check(_age() == 1, "load counts the boot");
+
+	// Any key mismatch must be rejected and leave the table untouched.
+	_fill(table, 0);
+	memcpy(&other, &key, sizeof(other));
+	other.ecid[3] ^= 1;
+	_check(!minerva_cache_load(&other, table), "other console ECID is rejected");
+
+	memcpy(&other, &key, sizeof(other));
+	other.sdram_id = 7;
+	_check(!minerva_cache_load(&other, table), "other DRAM id is rejected");
+
+	memcpy(&other, &key, sizeof(other));
+	other.chip_id = 0x18;
+	_check(!minerva_cache_load(&other, table), "other chip id is rejected");
+
+	memcpy(&other, &key, sizeof(other));
+	other.table_crc = 0;
+	_check(!minerva_cache_load(&other, table), "other Minerva table is rejected");
+
+	memcpy(&other, &key, sizeof(other));
+	other.entries = ENTRIES - 1;
+	_check(!minerva_cache_load(&other, table), "other entry count is rejected");
+
+	emc_table_t *untouched = malloc(size);
+	_fill(untouched, 0);
+	_check(!memcmp(table, untouched, size), "rejected load leaves the table alone");
+	free(untouched);
+
+	// Corruption.
+	u8 bad = 0x5A;
+	minerva_cache_save(&key, trained);
+	_check(_patch(sizeof(mtc_cache_hdr_t) + size / 2, &bad, 1) && !minerva_cache_load(&key, table),
+		"corrupt trained table is rejected");
+
+	u32 magic = 0;
+	minerva_cache_save(&key, trained);
+	_check(_patch(0, &magic, sizeof(magic)) && !minerva_cache_load(&key, table), "bad magic is rejected");
+
+	minerva_cache_save(&key, trained);
+	_check(_truncate(sizeof(mtc_cache_hdr_t) + size - 1) && !minerva_cache_load(&key, table),
+		"truncated file is rejected");
+
+	// Expiry.
+	minerva_cache_save(&key, trained);
+	u32 loads = 0;
+	while (loads <= MTC_CACHE_MAX_AGE && minerva_cache_load(&key, table))
+		loads++;
+	_check(loads == MTC_CACHE_MAX_AGE, "cache expires after MTC_CACHE_MAX_AGE loads");
+
+	minerva_cache_save(&key, trained);
+	_check(_age() == 0 && minerva_cache_load(&key, table), "retrain resets the age");
+
+	f_mount(NULL, "", 0);
+	free(disk);
+	free(trained);
+	free(table);
+
+	printf("%s\n", failed ? "FAILED" : "OK");
+
+	return failed ? 1 : 0;
+}
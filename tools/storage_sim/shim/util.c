@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Host versions of the bdk utils/util.c helpers the tests link against.
+
+#include <utils/types.h>
+
+// Same CRC32 as bdk crc32_calc() (reflected, poly 0xEDB88320).
+u32 crc32_calc(u32 crc, const u8 *buf, u32 len)
+{
+	crc = ~crc;
+	while (len--)
+	{
+		crc ^= *buf++;
+		for (u32 i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+
+	return ~crc;
+}
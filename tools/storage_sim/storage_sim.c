@@ -0,0 +1,635 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Links the real FatFs (bdk/libs/fatfs) with the Nyx configuration against a
+ * file-backed disk. Each disk command is charged a modeled time based on a
+ * per-command latency and a read/write bandwidth, mirroring the command split
+ * of sdmmc_storage_read/write. This allows filesystem side changes to be
+ * compared off-device.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <libs/fatfs/ff.h>
+#include <libs/fatfs/diskio.h>
+
+#define SECTOR_SIZE      512
+#define MAX_CMD_SECTORS  0xFFFF // Same as sdmmc_storage_readwrite.
+#define CHUNK_SIZE       0x400000 // 4MB, same as backup/restore tools.
+
+// BPMP cache maintenance, as done by sdmmc_driver.c and bpmp.c.
+#define CACHE_LINE_SIZE  0x20
+#define CACHE_RANGE_MAX  0x4000 // BPMP_MMU_MAINT_RANGE_MAX.
+#define ADMA2_DESC_SIZE  16
+#define ADMA2_DESC_LEN   0xFE00 // SDMMC_ADMA2_DESC_MAX_LEN.
+
+typedef struct _sim_model_t
+{
+	const char *name;
+	u32 cmd_lat_us;
+	u32 rd_kib_s;
+	u32 wr_kib_s;
+	u32 trim_lat_us;
+} sim_model_t;
+
+typedef struct _sim_stats_t
+{
+	u64 rd_cmds;
+	u64 rd_sectors;
+	u64 wr_cmds;
+	u64 wr_sectors;
+	u64 trim_cmds;
+	u64 trim_sectors;
+	u64 time_us;
+	u64 maint_way_old; // Whole cache walks with the old per transfer flush.
+	u64 maint_way;     // Whole cache walks with range maintenance.
+	u64 maint_lines;   // Single line requests with range maintenance.
+} sim_stats_t;
+
+static const sim_model_t models[] = {
+	{ "sd",   150, 90 * 1024,  60 * 1024,  2000 }, // UHS-I SDR104.
+	{ "emmc",  60, 300 * 1024, 150 * 1024, 1000 }, // HS400.
+};
+
+static sim_model_t model;
+static sim_stats_t stats;
+static int img_fd = -1;
+static u32 img_sectors;
+static FILE *trace_fp;
+
+static void _trace(const char *op, u32 sector, u32 count, u32 time_us)
+{
+	if (trace_fp)
+		fprintf(trace_fp, "%s,%u,%u,%u\n", op, sector, count, time_us);
+}
+
+static u32 _model_cmd(u32 count, u32 kib_s)
+{
+	return model.cmd_lat_us + (u32)(((u64)count * SECTOR_SIZE * 1000000) / ((u64)kib_s * 1024));
+}
+
+static void _model_maint_range(u32 size)
+{
+	// Buffers are assumed line aligned.
+	if (size > CACHE_RANGE_MAX)
+		stats.maint_way++;
+	else
+		stats.maint_lines += (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE;
+}
+
+// Cache maintenance of one data command.
+static void _model_maint(u32 count, int is_write)
+{
+	u32 size = count * SECTOR_SIZE;
+	u32 descs = (size + ADMA2_DESC_LEN - 1) / ADMA2_DESC_LEN;
+
+	// Clean and invalidate of all ways before and after the transfer.
+	stats.maint_way_old += 2;
+
+	// ADMA2 table clean, buffer clean and, for reads, its invalidate after the transfer.
+	_model_maint_range(descs * ADMA2_DESC_SIZE);
+	_model_maint_range(size);
+	if (!is_write)
+		_model_maint_range(size);
+}
+
+/*
+ * FatFs glue.
+ */
+
+DSTATUS disk_status(BYTE pdrv)
+{
+	(void)pdrv;
+
+	return 0;
+}
+
+DSTATUS disk_initialize(BYTE pdrv)
+{
+	(void)pdrv;
+
+	return 0;
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+	if (pdrv != DRIVE_SD || sector + count > img_sectors)
+		return RES_PARERR;
+
+	if (pread(img_fd, buff, (size_t)count * SECTOR_SIZE, (off_t)sector * SECTOR_SIZE) != (ssize_t)count * SECTOR_SIZE)
+		return RES_ERROR;
+
+	while (count)
+	{
+		u32 num = count > MAX_CMD_SECTORS ? MAX_CMD_SECTORS : count;
+		u32 time_us = _model_cmd(num, model.rd_kib_s);
+
+		stats.rd_cmds++;
+		stats.rd_sectors += num;
+		stats.time_us += time_us;
+		_model_maint(num, 0);
+		_trace("rd", sector, num, time_us);
+
+		sector += num;
+		count -= num;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+	if (pdrv != DRIVE_SD || sector + count > img_sectors)
+		return RES_PARERR;
+
+	if (pwrite(img_fd, buff, (size_t)count * SECTOR_SIZE, (off_t)sector * SECTOR_SIZE) != (ssize_t)count * SECTOR_SIZE)
+		return RES_ERROR;
+
+	while (count)
+	{
+		u32 num = count > MAX_CMD_SECTORS ? MAX_CMD_SECTORS : count;
+		u32 time_us = _model_cmd(num, model.wr_kib_s);
+
+		stats.wr_cmds++;
+		stats.wr_sectors += num;
+		stats.time_us += time_us;
+		_model_maint(num, 1);
+		_trace("wr", sector, num, time_us);
+
+		sector += num;
+		count -= num;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+	DWORD *buf = (DWORD *)buff;
+
+	if (pdrv != DRIVE_SD)
+		return RES_PARERR;
+
+	switch (cmd)
+	{
+	case GET_SECTOR_COUNT:
+		*buf = img_sectors;
+		break;
+	case GET_BLOCK_SIZE:
+		*buf = 32768; // Align to 16MB.
+		break;
+	case CTRL_TRIM:
+		stats.trim_cmds++;
+		stats.trim_sectors += buf[1] - buf[0] + 1;
+		stats.time_us += model.trim_lat_us;
+		_trace("trim", buf[0], buf[1] - buf[0] + 1, model.trim_lat_us);
+		break;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_set_info(BYTE pdrv, BYTE cmd, void *buff)
+{
+	(void)pdrv;
+	(void)cmd;
+	(void)buff;
+
+	return RES_OK;
+}
+
+void *ff_memalloc(UINT msize)
+{
+	return malloc(msize);
+}
+
+void ff_memfree(void *mblock)
+{
+	free(mblock);
+}
+
+DWORD get_fattime(void)
+{
+	return ((DWORD)(2026 - 1980) << 25) | (1 << 21) | (1 << 16);
+}
+
+// FatFs error printing.
+void gfx_printf(const char *fmt, ...)
+{
+	(void)fmt;
+}
+
+/*
+ * Workloads.
+ */
+
+static u8 *chunk_buf;
+
+static int _write_file(const char *path, u32 size)
+{
+	FIL fp;
+	UINT bw;
+
+	if (f_open(&fp, path, FA_CREATE_ALWAYS | FA_WRITE))
+		return 1;
+
+	while (size)
+	{
+		u32 num = size > CHUNK_SIZE ? CHUNK_SIZE : size;
+		if (f_write(&fp, chunk_buf, num, &bw) || bw != num)
+		{
+			f_close(&fp);
+			return 1;
+		}
+		size -= num;
+	}
+
+	return f_close(&fp);
+}
+
+static int _read_file(const char *path, u32 chunk)
+{
+	FIL fp;
+	UINT br;
+
+	if (f_open(&fp, path, FA_READ))
+		return 1;
+
+	do
+	{
+		if (f_read(&fp, chunk_buf, chunk, &br))
+		{
+			f_close(&fp);
+			return 1;
+		}
+	} while (br == chunk);
+
+	return f_close(&fp);
+}
+
+static int _wl_boot_setup()
+{
+	f_mkdir("bootloader");
+	f_mkdir("bootloader/sys");
+
+	return _write_file("bootloader/hekate_ipl.ini", 0x800) ||
+		_write_file("bootloader/nyx.ini", 0x200) ||
+		_write_file("bootloader/sys/nyx.bin", 0xC0000) ||
+		_write_file("bootloader/sys/res.pak", 0x300000) ||
+		_write_file("bootloader/sys/libsys_lp0.bso", 0x4000) ||
+		_write_file("bootloader/sys/libsys_minerva.bso", 0x20000);
+}
+
+// Config parsing and payload loading, as done on boot.
+static int _wl_boot()
+{
+	return _read_file("bootloader/hekate_ipl.ini", 0x200) ||
+		_read_file("bootloader/nyx.ini", 0x200) ||
+		_read_file("bootloader/sys/libsys_minerva.bso", CHUNK_SIZE) ||
+		_read_file("bootloader/sys/libsys_lp0.bso", CHUNK_SIZE) ||
+		_read_file("bootloader/sys/nyx.bin", CHUNK_SIZE) ||
+		_read_file("bootloader/sys/res.pak", CHUNK_SIZE);
+}
+
+static u32 backup_mb = 256;
+
+static int _wl_backup_setup()
+{
+	f_mkdir("backup");
+
+	return 0;
+}
+
+static int _wl_backup()
+{
+	return _write_file("backup/rawnand.bin", backup_mb << 20);
+}
+
+static int _wl_restore_setup()
+{
+	return _write_file("backup/rawnand.bin", backup_mb << 20);
+}
+
+static int _wl_restore()
+{
+	return _read_file("backup/rawnand.bin", CHUNK_SIZE);
+}
+
+static int _wl_abit_setup()
+{
+	char path[64];
+
+	f_mkdir("Nintendo");
+	f_mkdir("Nintendo/Contents");
+	for (u32 i = 0; i < 64; i++)
+	{
+		sprintf(path, "Nintendo/Contents/%08X.nca", i);
+		f_mkdir(path);
+		for (u32 j = 0; j < 4; j++)
+		{
+			sprintf(path, "Nintendo/Contents/%08X.nca/%02d", i, j);
+			if (_write_file(path, 0x10000))
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
+// Fix archive bit, same walk as the Nyx tool.
+static int _wl_abit_walk(char *path)
+{
+	DIR dir;
+	FILINFO fno;
+	u32 len = strlen(path);
+
+	if (f_opendir(&dir, path))
+		return 1;
+
+	while (!f_readdir(&dir, &fno) && fno.fname[0])
+	{
+		sprintf(path + len, "/%s", fno.fname);
+		if (fno.fattrib & AM_DIR)
+		{
+			if (strstr(fno.fname, ".nca"))
+				f_chmod(path, AM_ARC, AM_ARC);
+			else
+				f_chmod(path, 0, AM_ARC);
+
+			if (_wl_abit_walk(path))
+				return 1;
+		}
+		else
+			f_chmod(path, 0, AM_ARC);
+		path[len] = 0;
+	}
+
+	return f_closedir(&dir);
+}
+
+static int _wl_abit()
+{
+	char path[256] = "Nintendo";
+	return _wl_abit_walk(path);
+}
+
+static int _wl_seek_setup()
+{
+	return _write_file("backup/rawnand.bin", backup_mb << 20);
+}
+
+// Cluster chain walk without fast seek.
+static int _wl_seek()
+{
+	FIL fp;
+
+	if (f_open(&fp, "backup/rawnand.bin", FA_READ))
+		return 1;
+
+	for (u32 i = 0; i < 16; i++)
+	{
+		if (f_lseek(&fp, f_size(&fp) - (i & 1 ? 0 : CHUNK_SIZE)) || f_lseek(&fp, 0))
+		{
+			f_close(&fp);
+			return 1;
+		}
+	}
+
+	return f_close(&fp);
+}
+
+// Full FAT/bitmap scan, FSINFO is not trusted.
+static int _wl_getfree()
+{
+	DWORD nclst;
+	FATFS *fs;
+	return f_getfree("", &nclst, &fs);
+}
+
+static int _wl_discard()
+{
+	DWORD nclst;
+	return f_discard_free("", &nclst, NULL);
+}
+
+typedef struct _workload_t
+{
+	const char *name;
+	int (*setup)();
+	int (*run)();
+} workload_t;
+
+static const workload_t workloads[] = {
+	{ "boot",    _wl_boot_setup,    _wl_boot    },
+	{ "backup",  _wl_backup_setup,  _wl_backup  },
+	{ "restore", _wl_restore_setup, _wl_restore },
+	{ "abit",    _wl_abit_setup,    _wl_abit    },
+	{ "seek",    _wl_seek_setup,    _wl_seek    },
+	{ "getfree", NULL,              _wl_getfree },
+	{ "discard", NULL,              _wl_discard },
+};
+
+static void _usage(const char *name)
+{
+	fprintf(stderr,
+		"Usage: %s [options] <workload> [workload ...]\n"
+		" -i <file>    Disk image (default: storage_sim.img, created if missing)\n"
+		" -s <MiB>     Image size when creating (default: 4096)\n"
+		" -m <model>   sd or emmc (default: sd)\n"
+		" -l <us>      Per command latency override\n"
+		" -r <KiB/s>   Read bandwidth override\n"
+		" -w <KiB/s>   Write bandwidth override\n"
+		" -b <MiB>     Backup/restore size (default: 256)\n"
+		" -t <file>    Write I/O trace CSV\n"
+		" -f           Format image before running\n"
+		" -n           Disable the FatFs window cache\n"
+		"Workloads: boot, backup, restore, abit, seek, getfree, discard\n", name);
+}
+
+static int no_wcache;
+
+static int _mount(FATFS *fs)
+{
+	f_mount(NULL, "", 0);
+	int res = f_mount(fs, "", 1);
+
+	// Run with the single sector window only.
+	if (no_wcache && fs->wc_buf)
+	{
+		ff_memfree(fs->wc_buf);
+		fs->wc_buf = NULL;
+	}
+
+	return res;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *img_path = "storage_sim.img";
+	u32 img_mb = 4096;
+	int format = 0;
+	int opt;
+
+	model = models[0];
+	while ((opt = getopt(argc, argv, "i:s:m:l:r:w:b:t:fn")) != -1)
+	{
+		switch (opt)
+		{
+		case 'i':
+			img_path = optarg;
+			break;
+		case 's':
+			img_mb = atoi(optarg);
+			break;
+		case 'm':
+			for (u32 i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+				if (!strcmp(models[i].name, optarg))
+					model = models[i];
+			break;
+		case 'l':
+			model.cmd_lat_us = atoi(optarg);
+			break;
+		case 'r':
+			model.rd_kib_s = atoi(optarg);
+			break;
+		case 'w':
+			model.wr_kib_s = atoi(optarg);
+			break;
+		case 'b':
+			backup_mb = atoi(optarg);
+			break;
+		case 't':
+			trace_fp = fopen(optarg, "w");
+			if (trace_fp)
+				fprintf(trace_fp, "op,sector,count,time_us\n");
+			break;
+		case 'f':
+			format = 1;
+			break;
+		case 'n':
+			no_wcache = 1;
+			break;
+		default:
+			_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc || !model.rd_kib_s || !model.wr_kib_s)
+	{
+		_usage(argv[0]);
+		return 1;
+	}
+
+	img_fd = open(img_path, O_RDWR | O_CREAT, 0644);
+	if (img_fd < 0)
+	{
+		fprintf(stderr, "Failed to open %s\n", img_path);
+		return 1;
+	}
+
+	off_t img_size = lseek(img_fd, 0, SEEK_END);
+	if (!img_size)
+	{
+		img_size = (off_t)img_mb << 20;
+		if (ftruncate(img_fd, img_size))
+			return 1;
+		format = 1;
+	}
+	img_sectors = img_size / SECTOR_SIZE;
+
+	chunk_buf = malloc(CHUNK_SIZE);
+	memset(chunk_buf, 0xA5, CHUNK_SIZE);
+
+	FATFS fs;
+	if (format)
+	{
+		u8 *work = malloc(0x400000);
+		int res = f_mkfs("", FM_FAT32, 32768, work, 0x400000);
+		if (res)
+		{
+			fprintf(stderr, "Format failed (%d)\n", res);
+			return 1;
+		}
+		free(work);
+	}
+
+	if (_mount(&fs))
+	{
+		fprintf(stderr, "Mount failed\n");
+		return 1;
+	}
+
+	printf("Model: %s, %u us/cmd, rd %u KiB/s, wr %u KiB/s\n\n",
+		model.name, model.cmd_lat_us, model.rd_kib_s, model.wr_kib_s);
+	printf("%-8s %10s %12s %10s %12s %8s %12s %10s %10s %12s %10s %8s %10s\n",
+		"workload", "rd_cmds", "rd_sectors", "wr_cmds", "wr_sectors", "trims", "trim_sect",
+		"wc_hits", "wc_misses", "time_ms", "way_old", "way", "lines");
+
+	for (int i = optind; i < argc; i++)
+	{
+		const workload_t *wl = NULL;
+		for (u32 j = 0; j < sizeof(workloads) / sizeof(workloads[0]); j++)
+			if (!strcmp(workloads[j].name, argv[i]))
+				wl = &workloads[j];
+
+		if (!wl)
+		{
+			fprintf(stderr, "Unknown workload %s\n", argv[i]);
+			continue;
+		}
+
+		// Setup is not accounted. Remount to start with cold FatFs windows.
+		if (wl->setup && wl->setup())
+		{
+			fprintf(stderr, "%s: setup failed\n", wl->name);
+			continue;
+		}
+		_mount(&fs);
+
+		memset(&stats, 0, sizeof(stats));
+		if (trace_fp)
+			fprintf(trace_fp, "# %s\n", wl->name);
+
+		int res = wl->run();
+		u32 wc_hit = fs.wc_buf ? fs.wc_hit : 0;
+		u32 wc_miss = fs.wc_buf ? fs.wc_miss : 0;
+		_mount(&fs);
+
+		printf("%-8s %10llu %12llu %10llu %12llu %8llu %12llu %10u %10u %9llu.%02llu %10llu %8llu %10llu%s\n", wl->name,
+			(unsigned long long)stats.rd_cmds, (unsigned long long)stats.rd_sectors,
+			(unsigned long long)stats.wr_cmds, (unsigned long long)stats.wr_sectors,
+			(unsigned long long)stats.trim_cmds, (unsigned long long)stats.trim_sectors,
+			wc_hit, wc_miss,
+			(unsigned long long)(stats.time_us / 1000), (unsigned long long)(stats.time_us % 1000) / 10,
+			(unsigned long long)stats.maint_way_old, (unsigned long long)stats.maint_way,
+			(unsigned long long)stats.maint_lines, res ? " (failed)" : "");
+	}
+
+	f_mount(NULL, "", 0);
+	close(img_fd);
+	if (trace_fp)
+		fclose(trace_fp);
+	free(chunk_buf);
+
+	return 0;
+}